@@ -21,6 +21,79 @@
  * SOFTWARE.
  */
 
+inline bool isCubicInterpolation(HackAudio::Graph::InterpolationMode mode)
+{
+    return mode == HackAudio::Graph::CatmullRom
+        || mode == HackAudio::Graph::MonotoneCubic
+        || mode == HackAudio::Graph::Cardinal;
+}
+
+// The slope of the curve at a breakpoint from its neighbours, either of which may be missing.
+// Every cubic mode is a Hermite spline in X, and only differs in these slopes
+inline float getCubicTangent(const HackAudio::Graph::Breakpoint* previous, const HackAudio::Graph::Breakpoint& current, const HackAudio::Graph::Breakpoint* next, HackAudio::Graph::InterpolationMode mode)
+{
+
+    // A neighbour that isn't on the correct side along the X axis has no meaningful slope
+    const bool hasPrevious = previous != nullptr && current.x > previous->x;
+    const bool hasNext     = next != nullptr && next->x > current.x;
+
+    const float before = (hasPrevious) ? (current.y - previous->y) / (current.x - previous->x) : 0.0f;
+    const float after  = (hasNext)     ? (next->y - current.y) / (next->x - current.x) : 0.0f;
+
+    const float scale = (mode == HackAudio::Graph::Cardinal) ? 1.0f - std::max(0.0f, std::min(1.0f, current.z)) : 1.0f;
+
+    if (!hasPrevious || !hasNext)
+        return scale * (before + after);
+
+    if (mode == HackAudio::Graph::MonotoneCubic)
+    {
+
+        // Steffen's method, which only needs the two neighbouring slopes
+        if (before * after <= 0.0f)
+            return 0.0f;
+
+        const float widthBefore = current.x - previous->x;
+        const float widthAfter  = next->x - current.x;
+
+        const float slope = (before * widthAfter + after * widthBefore) / (widthBefore + widthAfter);
+        const float limit = 2.0f * std::min(std::abs(before), std::abs(after));
+
+        return (slope > 0.0f) ? std::min(slope, limit) : std::max(slope, -limit);
+
+    }
+
+    return scale * (next->y - previous->y) / (next->x - previous->x);
+
+}
+
+inline float evaluateCubic(const HackAudio::Graph::Breakpoint& from, const HackAudio::Graph::Breakpoint& to, float fromTangent, float toTangent, float x)
+{
+
+    const float width = to.x - from.x;
+
+    if (width <= 0.0f)
+        return to.y;
+
+    const float t  = std::max(0.0f, std::min(1.0f, (x - from.x) / width));
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+
+    return (2.0f * t3 - 3.0f * t2 + 1.0f) * from.y
+         + (t3 - 2.0f * t2 + t) * width * fromTangent
+         + (3.0f * t2 - 2.0f * t3) * to.y
+         + (t3 - t2) * width * toTangent;
+
+}
+
+// The slopes at both ends of the segment starting at breakpoints[index]
+inline void getCubicTangents(const HackAudio::Graph::Breakpoint* breakpoints, int numBreakpoints, int index, HackAudio::Graph::InterpolationMode mode, float& fromTangent, float& toTangent)
+{
+
+    fromTangent = getCubicTangent((index > 0) ? breakpoints + index - 1 : nullptr, breakpoints[index], breakpoints + index + 1, mode);
+    toTangent   = getCubicTangent(breakpoints + index, breakpoints[index + 1], (index + 2 < numBreakpoints) ? breakpoints + index + 2 : nullptr, mode);
+
+}
+
 HackAudio::Graph::Node::Node(HackAudio::Graph* graph) : owner(*graph)
 {
 
@@ -40,6 +113,8 @@ HackAudio::Graph::Node::Node(HackAudio::Graph* graph) : owner(*graph)
 
     z = 0.0f;
 
+    index = -1;
+
     setSize(owner.nodeSize, owner.nodeSize);
 
 }
@@ -225,11 +300,14 @@ void HackAudio::Graph::Node::mouseExit(const juce::MouseEvent& e)
 
     setMouseCursor(juce::MouseCursor::NormalCursor);
 
+    owner.releasePointNode(this);
+
 }
 
 void HackAudio::Graph::Node::mouseDown(const juce::MouseEvent& e)
 {
 
+    owner.beginJournalTransaction();
     owner.dragger.startDraggingComponent(this, e);
 
 }
@@ -263,6 +341,8 @@ void HackAudio::Graph::Node::mouseDrag(const juce::MouseEvent& e)
 bool HackAudio::Graph::Node::keyPressed(const juce::KeyPress& key)
 {
 
+    owner.beginJournalTransaction();
+
     int x = getX();
     int y = getY();
 
@@ -317,6 +397,8 @@ void HackAudio::Graph::Node::focusLost(juce::Component::FocusChangeType cause)
 
     repaint();
 
+    owner.releasePointNode(this);
+
 }
 
 void HackAudio::Graph::Node::colourChanged()
@@ -352,468 +434,3105 @@ void HackAudio::Graph::Node::paint(juce::Graphics& g)
 
 }
 
-HackAudio::Graph::Graph()
+HackAudio::Graph::Snapshot::Snapshot()
 {
 
-    setColour(HackAudio::backgroundColourId, HackAudio::Colours::Black);
-    setColour(HackAudio::midgroundColourId,  HackAudio::Colours::Gray);
-    setColour(HackAudio::foregroundColourId, HackAudio::Colours::White);
-    setColour(HackAudio::highlightColourId,  HackAudio::Colours::Cyan);
+    mode = Linear;
 
-    setWantsKeyboardFocus(false);
-    setMouseClickGrabsKeyboardFocus(false);
+}
 
-    contentContainer.addMouseListener(this, false);
-    addAndMakeVisible(contentContainer);
+float HackAudio::Graph::Snapshot::evaluate(float x) const
+{
 
-    nodeSize = 24;
-    lineWidth = 4.0f;
+    const int numBreakpoints = breakpoints.size();
 
-    constraints.setSizeLimits(nodeSize, nodeSize, nodeSize, nodeSize);
-    constraints.setMinimumOnscreenAmounts(nodeSize, nodeSize, nodeSize, nodeSize);
+    if (numBreakpoints == 0)
+        return 0.0f;
 
-    startPoint = 0.5f;
-    endPoint   = 0.5f;
-    startAndEndShown = true;
+    const Breakpoint* points = breakpoints.begin();
 
-}
+    if (x <= points[0].x)
+        return points[0].y;
 
-HackAudio::Graph::~Graph()
-{
+    if (x >= points[numBreakpoints - 1].x)
+        return points[numBreakpoints - 1].y;
 
-    graphNodes.clear();
+    const Breakpoint* upper = std::upper_bound(points, points + numBreakpoints, x, [](float value, const Breakpoint& point)
+    {
+
+        return value < point.x;
+
+    });
+
+    return interpolate((int)(upper - points) - 1, x);
 
 }
 
-HackAudio::Graph::Node* HackAudio::Graph::add()
+void HackAudio::Graph::Snapshot::evaluate(float* destination, int numSamples) const
 {
 
-    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
-    n->addComponentListener(this);
-    graphNodes.add(n);
+    if (numSamples <= 0)
+        return;
 
-    contentContainer.addAndMakeVisible(n);
-    n->setCentreRelative(0.5f, 0.5f);
+    const int numBreakpoints = breakpoints.size();
 
-    nodeOrderChanged();
+    if (numBreakpoints == 0)
+    {
 
-    return n;
+        juce::FloatVectorOperations::clear(destination, numSamples);
+        return;
 
-}
+    }
 
-HackAudio::Graph::Node* HackAudio::Graph::add(const juce::String& nodeId)
-{
+    const Breakpoint* points = breakpoints.begin();
 
-    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
-    n->setComponentID(nodeId);
-    n->addComponentListener(this);
-    graphNodes.add(n);
+    const float step = (numSamples > 1) ? 1.0f / (numSamples - 1) : 0.0f;
 
-    contentContainer.addAndMakeVisible(n);
-    n->setCentreRelative(0.5f, 0.5f);
+    // The index of the first sample lying beyond the given X value
+    auto firstSampleAfter = [step, numSamples](float x)
+    {
 
-    nodeOrderChanged();
+        if (step <= 0.0f)
+            return (x < 0.0f) ? 0 : numSamples;
 
-    return n;
+        return juce::jlimit(0, numSamples, (int)std::floor(x / step) + 1);
 
-}
+    };
 
-HackAudio::Graph::Node* HackAudio::Graph::insert(int index)
-{
+    int sample = firstSampleAfter(points[0].x);
 
-    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
-    n->addComponentListener(this);
-    graphNodes.insert(index, n);
+    juce::FloatVectorOperations::fill(destination, points[0].y, sample);
 
-    contentContainer.addAndMakeVisible(n);
-    n->setCentreRelative(0.5f, 0.5f);
+    for (int i = 1; i < numBreakpoints; ++i)
+    {
 
-    nodeOrderChanged();
+        const int end = firstSampleAfter(points[i].x);
 
-    return n;
+        if (end <= sample)
+            continue;
 
-}
+        const Breakpoint& from = points[i - 1];
+        const Breakpoint& to   = points[i];
 
-HackAudio::Graph::Node* HackAudio::Graph::insert(int index, const juce::String& nodeId)
-{
+        if (interpolator)
+        {
 
-    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
-    n->setComponentID(nodeId);
-    n->addComponentListener(this);
-    graphNodes.insert(index, n);
+            for (int j = sample; j < end; ++j)
+            {
 
-    contentContainer.addAndMakeVisible(n);
-    n->setCentreRelative(0.5f, 0.5f);
+                destination[j] = interpolate(i - 1, j * step);
 
-    nodeOrderChanged();
+            }
 
-    return n;
+        }
+        else if (isCubicInterpolation(mode))
+        {
 
-}
+            // The slopes only depend on the neighbouring breakpoints, so they're found once per segment
+            float fromTangent, toTangent;
+            getCubicTangents(points, numBreakpoints, i - 1, mode, fromTangent, toTangent);
 
-HackAudio::Graph::Node* HackAudio::Graph::getNode(int index) const
-{
+            for (int j = sample; j < end; ++j)
+            {
 
-    return graphNodes[index];
+                destination[j] = evaluateCubic(from, to, fromTangent, toTangent, j * step);
 
-}
+            }
 
-HackAudio::Graph::Node* HackAudio::Graph::getNode(const juce::String& nodeId) const
-{
+        }
+        else
+        {
 
-    return (HackAudio::Graph::Node*)contentContainer.findChildWithID(nodeId);
+            // A straight segment is an affine function of the sample index
+            const float slope     = (to.y - from.y) / (to.x - from.x);
+            const float offset    = from.y + (sample * step - from.x) * slope;
+            const float increment = step * slope;
 
-}
+            float* segment = destination + sample;
+            const int count = end - sample;
 
-void HackAudio::Graph::remove(int index)
-{
+            for (int j = 0; j < count; ++j)
+            {
 
-    graphNodes[index]->removeComponentListener(this);
-    graphNodes.remove(index);
-    nodeOrderChanged();
+                segment[j] = offset + increment * j;
+
+            }
+
+        }
+
+        sample = end;
+
+    }
+
+    juce::FloatVectorOperations::fill(destination + sample, points[numBreakpoints - 1].y, numSamples - sample);
 
 }
 
-void HackAudio::Graph::remove(const juce::String& nodeId)
+int HackAudio::Graph::Snapshot::getNumBreakpoints() const
 {
 
-    HackAudio::Graph::Node* n = (HackAudio::Graph::Node*)contentContainer.findChildWithID(nodeId);
-
-    n->removeComponentListener(this);
-    graphNodes.removeObject(n);
-    nodeOrderChanged();
+    return breakpoints.size();
 
 }
 
-void HackAudio::Graph::setNodeSize(int newSize)
+HackAudio::Graph::Breakpoint HackAudio::Graph::Snapshot::getBreakpoint(int index) const
 {
 
-    jassert(nodeSize > 0);
+    return breakpoints[index];
 
-    nodeSize = newSize;
+}
 
-    constraints.setSizeLimits(nodeSize, nodeSize, nodeSize, nodeSize);
+float HackAudio::Graph::Snapshot::interpolate(int index, float x) const
+{
 
-    for (int i = 0; i < graphNodes.size(); ++i)
+    const Breakpoint& from = breakpoints.getReference(index);
+    const Breakpoint& to   = breakpoints.getReference(index + 1);
+
+    if (isCubicInterpolation(mode))
     {
 
-        HackAudio::Graph::Node* n = graphNodes[i];
+        float fromTangent, toTangent;
+        getCubicTangents(breakpoints.begin(), breakpoints.size(), index, mode, fromTangent, toTangent);
 
-        float x = n->getXValue();
-        float y = n->getYValue();
+        return evaluateCubic(from, to, fromTangent, toTangent, x);
 
-        n->setSize(nodeSize, nodeSize);
+    }
 
-        n->setXValue(x);
-        n->setYValue(y);
+    const float width = to.x - from.x;
 
-    }
+    if (width <= 0.0f)
+        return to.y;
 
-}
+    const float proportion = juce::jlimit(0.0f, 1.0f, (x - from.x) / width);
 
-int HackAudio::Graph::getNodeSize() const
-{
+    if (interpolator)
+        return interpolator(from, to, proportion);
 
-    return nodeSize;
+    return from.y + (to.y - from.y) * proportion;
 
 }
 
-void HackAudio::Graph::setLineWidth(float width)
+template <typename ElementType>
+HackAudio::Graph::RealtimeBuffer<ElementType>::RealtimeBuffer(int capacity)
+    : storage((size_t)capacity * 3, true),
+      bufferCapacity(capacity),
+      sharedIndex(1)
 {
 
-    jassert(lineWidth > 0.0f);
+    sizes[0] = sizes[1] = sizes[2] = 0;
 
-    lineWidth = width;
-    repaint();
+    writeIndex = 0;
+    readIndex  = 2;
 
 }
 
-float HackAudio::Graph::getLineWidth() const
+template <typename ElementType>
+ElementType* HackAudio::Graph::RealtimeBuffer<ElementType>::getWriteBuffer()
 {
 
-    return lineWidth;
+    return storage + writeIndex * bufferCapacity;
 
 }
 
-void HackAudio::Graph::setGraphPointStatus(bool shouldShowStartAndEndPoints)
+template <typename ElementType>
+int HackAudio::Graph::RealtimeBuffer<ElementType>::getCapacity() const
 {
 
-    startAndEndShown = shouldShowStartAndEndPoints;
-    repaint();
+    return bufferCapacity;
 
 }
 
-bool HackAudio::Graph::getGraphPointStatus() const
+template <typename ElementType>
+void HackAudio::Graph::RealtimeBuffer<ElementType>::publish(int numElements)
 {
 
-    return startAndEndShown;
+    sizes[writeIndex] = numElements;
+
+    // The written buffer becomes the shared one, and the writer takes whichever buffer was
+    // shared before. The reader's buffer is never part of the exchange
+    writeIndex = sharedIndex.exchange(writeIndex | newDataFlag) & ~newDataFlag;
 
 }
 
-void HackAudio::Graph::setStartPoint(float pos)
+template <typename ElementType>
+const ElementType* HackAudio::Graph::RealtimeBuffer<ElementType>::read(int& numElements)
 {
 
-    jassert(pos >= 0.0f && pos <= 1.0f);
-    startPoint = contentContainer.getY() + (pos * contentContainer.getHeight());
-    repaint();
+    if (sharedIndex.load() & newDataFlag)
+    {
 
-}
+        readIndex = sharedIndex.exchange(readIndex) & ~newDataFlag;
 
-float HackAudio::Graph::getStartPoint() const
-{
+    }
 
-    return startPoint;
+    numElements = sizes[readIndex];
+
+    return storage + readIndex * bufferCapacity;
 
 }
 
-void HackAudio::Graph::setEndPoint(float pos)
+HackAudio::Graph::SpectrumThread::SpectrumThread() : juce::TimeSliceThread("HackAudio Graph Spectrum")
 {
 
-    jassert(pos >= 0.0f && pos <= 1.0f);
-    endPoint = contentContainer.getY() + (pos * contentContainer.getHeight());
-    repaint();
-
 }
 
-float HackAudio::Graph::getEndPoint() const
+HackAudio::Graph::SpectrumThread::~SpectrumThread()
 {
 
-    return endPoint;
+    stopThread(1000);
 
 }
 
-void HackAudio::Graph::setXRange(int min, int max)
+HackAudio::Graph::Spectrum::Spectrum(HackAudio::Graph& graph, double sampleRate, float minFrequency, float maxFrequency, int fftOrder)
+    : owner(graph),
+      fifo(fifoSize),
+      fifoSamples(fifoSize),
+      fftSize(1 << fftOrder),
+      hopSize(fftSize / 4),
+      input(fftSize, true),
+      window(fftSize),
+      real(fftSize),
+      imaginary(fftSize),
+      cosines(fftSize / 2),
+      sines(fftSize / 2),
+      bitReversed(fftSize),
+      power(fftSize / 2 + 1),
+      bandStart(numBands),
+      bandEnd(numBands),
+      bandLevels(numBands),
+      smoothedLevels(numBands, true),
+      minDecibels(-90.0f),
+      maxDecibels(0.0f),
+      updated(false),
+      levels(numBands)
 {
 
-    xmin = min;
-    xmax = max;
+    jassert(fftOrder >= 4 && fftOrder <= 15);
+    jassert(minFrequency > 0.0f && minFrequency < maxFrequency);
+    jassert(maxFrequency <= sampleRate / 2.0);   /* Warning: Frequencies Above Nyquist Can't Be Shown */
 
-}
+    inputPosition   = 0;
+    samplesUntilHop = hopSize;
 
-void HackAudio::Graph::setXRange(float min, float max)
-{
+    const double pi = juce::MathConstants<double>::pi;
 
-    xmin = min;
-    xmax = max;
+    for (int i = 0; i < fftSize; ++i)
+    {
 
-}
+        window[i] = (float)(0.5 - 0.5 * std::cos(2.0 * pi * i / fftSize));
 
-void HackAudio::Graph::setXRange(double min, double max)
-{
+        int reversed = 0;
 
-    xmin = min;
-    xmax = max;
-    
-}
+        for (int bit = 0; bit < fftOrder; ++bit)
+        {
 
-juce::var HackAudio::Graph::getXMin() const
-{
+            reversed |= ((i >> bit) & 1) << (fftOrder - 1 - bit);
 
-    return xmin;
+        }
 
-}
+        bitReversed[i] = reversed;
 
-juce::var HackAudio::Graph::getXMax() const
-{
+    }
 
-    return xmax;
-    
-}
+    for (int i = 0; i < fftSize / 2; ++i)
+    {
 
-void HackAudio::Graph::setXUnits(const juce::String& units)
-{
+        cosines[i] = (float)std::cos(2.0 * pi * i / fftSize);
+        sines[i]   = (float)-std::sin(2.0 * pi * i / fftSize);
 
-    xUnits = units;
+    }
 
-}
+    // A full scale sine through a Hann window peaks at a quarter of the FFT size
+    powerScale = 16.0f / ((float)fftSize * (float)fftSize);
+    hopSeconds = (float)(hopSize / sampleRate);
 
-juce::String HackAudio::Graph::getXUnits() const
-{
+    // Each band takes the loudest bin between its edges, or the nearest bin where it's narrower
+    // than one bin at low frequencies
+    const double binsPerHertz = fftSize / sampleRate;
+    const double ratio        = maxFrequency / (double)minFrequency;
 
-    return xUnits;
+    for (int band = 0; band < numBands; ++band)
+    {
 
-}
+        const double low  = minFrequency * std::pow(ratio, (double)band / numBands) * binsPerHertz;
+        const double high = minFrequency * std::pow(ratio, (double)(band + 1) / numBands) * binsPerHertz;
 
-void HackAudio::Graph::setYRange(int min, int max)
-{
+        bandStart[band] = juce::jlimit(0, fftSize / 2, (int)std::floor(low + 0.5));
+        bandEnd[band]   = juce::jlimit(bandStart[band] + 1, fftSize / 2 + 1, (int)std::ceil(high));
 
-    ymin = min;
-    ymax = max;
+    }
+
+    spectrumThread->addTimeSliceClient(this);
+
+    if (!spectrumThread->isThreadRunning())
+        spectrumThread->startThread();
 
 }
 
-void HackAudio::Graph::setYRange(float min, float max)
+HackAudio::Graph::Spectrum::~Spectrum()
 {
 
-    ymin = min;
-    ymax = max;
+    stopTimer();
+
+    // This waits for any slice in progress, so the spectrum can be safely destroyed afterwards
+    spectrumThread->removeTimeSliceClient(this);
 
 }
 
-void HackAudio::Graph::setYRange(double min, double max)
+void HackAudio::Graph::Spectrum::push(const float* samples, int numSamples)
 {
 
-    ymin = min;
-    ymax = max;
+    const int numToWrite = std::min(numSamples, fifo.getFreeSpace());
 
-}
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numToWrite, start1, size1, start2, size2);
 
-juce::var HackAudio::Graph::getYMin() const
-{
+    if (size1 > 0)
+        juce::FloatVectorOperations::copy(fifoSamples + start1, samples, size1);
 
-    return ymin;
+    if (size2 > 0)
+        juce::FloatVectorOperations::copy(fifoSamples + start2, samples + size1, size2);
+
+    fifo.finishedWrite(size1 + size2);
 
 }
 
-juce::var HackAudio::Graph::getYMax() const
+void HackAudio::Graph::Spectrum::setRange(float minimum, float maximum)
 {
 
-    return ymax;
+    jassert(minimum < maximum);
+
+    minDecibels = minimum;
+    maxDecibels = maximum;
+
+}
+
+void HackAudio::Graph::Spectrum::setRefreshRate(int framesPerSecond)
+{
+
+    jassert(framesPerSecond > 0);
+
+    startTimerHz(framesPerSecond);
+
+}
+
+void HackAudio::Graph::Spectrum::paint(juce::Graphics& g, juce::Rectangle<int> area)
+{
+
+    int numLevels;
+    const float* currentLevels = levels.read(numLevels);
+
+    if (numLevels == 0)
+        return;
+
+    const juce::Rectangle<float> bounds = area.toFloat();
+    const float bandWidth = bounds.getWidth() / numLevels;
+
+    // The path keeps its storage between frames, so repainting doesn't allocate
+    spectrumPath.clear();
+    spectrumPath.startNewSubPath(bounds.getX(), bounds.getBottom());
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+
+        spectrumPath.lineTo(bounds.getX() + bandWidth * (i + 0.5f), bounds.getBottom() - currentLevels[i] * bounds.getHeight());
+
+    }
+
+    spectrumPath.lineTo(bounds.getRight(), bounds.getBottom());
+    spectrumPath.closeSubPath();
+
+    g.fillPath(spectrumPath);
+
+}
+
+int HackAudio::Graph::Spectrum::useTimeSlice()
+{
+
+    const int numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+        return 10;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        process(fifoSamples + start1, size1);
+
+    if (size2 > 0)
+        process(fifoSamples + start2, size2);
+
+    fifo.finishedRead(size1 + size2);
+
+    return 10;
+
+}
+
+void HackAudio::Graph::Spectrum::timerCallback()
+{
+
+    if (updated.exchange(false))
+        owner.repaint(owner.contentContainer.getBounds());
+
+}
+
+void HackAudio::Graph::Spectrum::process(const float* samples, int numSamples)
+{
+
+    // Samples go into a circular buffer of the last fftSize samples, which is analysed every
+    // hopSize samples for a 75% overlap between frames
+    while (numSamples > 0)
+    {
+
+        const int numToCopy = std::min(numSamples, std::min(fftSize - inputPosition, samplesUntilHop));
+
+        juce::FloatVectorOperations::copy(input + inputPosition, samples, numToCopy);
+
+        samples    += numToCopy;
+        numSamples -= numToCopy;
+
+        inputPosition    = (inputPosition + numToCopy) % fftSize;
+        samplesUntilHop -= numToCopy;
+
+        if (samplesUntilHop == 0)
+        {
+
+            analyse();
+            samplesUntilHop = hopSize;
+
+        }
+
+    }
+
+}
+
+void HackAudio::Graph::Spectrum::analyse()
+{
+
+    const int numOldest = fftSize - inputPosition;
+
+    juce::FloatVectorOperations::multiply(real, input + inputPosition, window, numOldest);
+    juce::FloatVectorOperations::multiply(real + numOldest, input, window + numOldest, inputPosition);
+    juce::FloatVectorOperations::clear(imaginary, fftSize);
+
+    performFFT();
+
+    const int numBins = fftSize / 2 + 1;
+
+    juce::FloatVectorOperations::multiply(power, real, real, numBins);
+    juce::FloatVectorOperations::addWithMultiply(power, imaginary, imaginary, numBins);
+
+    const float minimum = minDecibels.load();
+    const float range   = maxDecibels.load() - minimum;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+
+        const float bandPower = juce::FloatVectorOperations::findMaximum(power + bandStart[band], bandEnd[band] - bandStart[band]);
+
+        bandLevels[band] = 10.0f * std::log10(bandPower * powerScale + 1.0e-12f);
+
+    }
+
+    // Levels are normalised to the range, then rise instantly and fall at 60dB a second
+    juce::FloatVectorOperations::add(bandLevels, -minimum, numBands);
+    juce::FloatVectorOperations::multiply(bandLevels, 1.0f / range, numBands);
+    juce::FloatVectorOperations::clip(bandLevels, bandLevels, 0.0f, 1.0f, numBands);
+
+    juce::FloatVectorOperations::add(smoothedLevels, -60.0f * hopSeconds / range, numBands);
+    juce::FloatVectorOperations::max(smoothedLevels, smoothedLevels, bandLevels, numBands);
+
+    juce::FloatVectorOperations::copy(levels.getWriteBuffer(), smoothedLevels, numBands);
+    levels.publish(numBands);
+
+    updated = true;
+
+}
+
+void HackAudio::Graph::Spectrum::performFFT()
+{
+
+    // An iterative radix-2 decimation-in-time FFT, in place on the real and imaginary arrays
+    for (int i = 0; i < fftSize; ++i)
+    {
+
+        const int j = bitReversed[i];
+
+        if (j > i)
+        {
+
+            std::swap(real[i], real[j]);
+            std::swap(imaginary[i], imaginary[j]);
+
+        }
+
+    }
+
+    for (int length = 2; length <= fftSize; length <<= 1)
+    {
+
+        const int half   = length / 2;
+        const int stride = fftSize / length;
+
+        for (int start = 0; start < fftSize; start += length)
+        {
+
+            for (int k = 0; k < half; ++k)
+            {
+
+                const float wr = cosines[k * stride];
+                const float wi = sines[k * stride];
+
+                const int a = start + k;
+                const int b = a + half;
+
+                const float tr = real[b] * wr - imaginary[b] * wi;
+                const float ti = real[b] * wi + imaginary[b] * wr;
+
+                real[b]      = real[a] - tr;
+                imaginary[b] = imaginary[a] - ti;
+                real[a]      += tr;
+                imaginary[a] += ti;
+
+            }
+
+        }
+
+    }
+
+}
+
+HackAudio::Graph::DataSeries::DataSeries(const float* values, int numValues, double firstX, double lastX)
+    : seriesValues((size_t)numValues),
+      numSeriesValues(numValues),
+      seriesFirstX(firstX),
+      seriesLastX(lastX)
+{
+
+    juce::FloatVectorOperations::copy(seriesValues, values, numValues);
+
+    // Level 1 summarises pairs of values, and each level above it pairs of the level below,
+    // which adds up to fewer entries than there are values
+    int total = 0;
+
+    for (int size = (numValues + 1) / 2; numValues > 1; size = (size + 1) / 2)
+    {
+
+        levelOffsets.add(total);
+        total += size;
+
+        if (size == 1)
+            break;
+
+    }
+
+    levelOffsets.add(total);
+
+    pyramid.malloc((size_t)std::max(1, total));
+
+    for (int level = 1; level < levelOffsets.size(); ++level)
+    {
+
+        juce::Range<float>* entries = pyramid + levelOffsets[level - 1];
+        const int size = levelOffsets[level] - levelOffsets[level - 1];
+
+        if (level == 1)
+        {
+
+            for (int i = 0; i < size; ++i)
+            {
+
+                const float a = values[i * 2];
+                const float b = values[std::min(i * 2 + 1, numValues - 1)];
+
+                entries[i] = juce::Range<float>(std::min(a, b), std::max(a, b));
+
+            }
+
+        }
+        else
+        {
+
+            const juce::Range<float>* below = pyramid + levelOffsets[level - 2];
+            const int belowSize = levelOffsets[level - 1] - levelOffsets[level - 2];
+
+            for (int i = 0; i < size; ++i)
+            {
+
+                entries[i] = below[i * 2].getUnionWith(below[std::min(i * 2 + 1, belowSize - 1)]);
+
+            }
+
+        }
+
+    }
+
+}
+
+double HackAudio::Graph::DataSeries::getFirstX() const
+{
+
+    return seriesFirstX;
+
+}
+
+double HackAudio::Graph::DataSeries::getLastX() const
+{
+
+    return seriesLastX;
+
+}
+
+void HackAudio::Graph::DataSeries::createPath(juce::Path& p, juce::Rectangle<float> area, double visibleStart, double visibleEnd, int firstColumn, int lastColumn) const
+{
+
+    p.clear();
+
+    if (numSeriesValues < 2 || area.isEmpty() || firstColumn >= lastColumn)
+        return;
+
+    const double valuesPerX      = (numSeriesValues - 1) / (seriesLastX - seriesFirstX);
+    const double startIndex      = (visibleStart - seriesFirstX) * valuesPerX;
+    const double valuesPerColumn = (visibleEnd - visibleStart) * valuesPerX / area.getWidth();
+
+    auto getY = [&](float value)
+    {
+
+        return area.getBottom() - value * area.getHeight();
+
+    };
+
+    if (valuesPerColumn <= 1.0)
+    {
+
+        // Zoomed in far enough to draw every visible value, which is at most one per column
+        const int first = juce::jlimit(0, numSeriesValues - 1, (int)std::floor(startIndex + firstColumn * valuesPerColumn));
+        const int last  = juce::jlimit(0, numSeriesValues - 1, (int)std::ceil(startIndex + lastColumn * valuesPerColumn));
+
+        for (int i = first; i <= last; ++i)
+        {
+
+            const float x = area.getX() + (float)((i - startIndex) / valuesPerColumn);
+
+            if (i == first)
+                p.startNewSubPath(x, getY(seriesValues[i]));
+            else
+                p.lineTo(x, getY(seriesValues[i]));
+
+        }
+
+        return;
+
+    }
+
+    // Otherwise each column is a vertical line from the minimum to the maximum of its values,
+    // read from the level whose entries are no wider than a column so only a few are needed
+    const int level = juce::jlimit(0, levelOffsets.size() - 1, (int)std::floor(std::log2(valuesPerColumn)));
+
+    for (int column = firstColumn; column < lastColumn; ++column)
+    {
+
+        const double from = startIndex + column * valuesPerColumn;
+
+        if (from + valuesPerColumn < 0.0 || from > numSeriesValues - 1)
+            continue;
+
+        const int start = juce::jlimit(0, numSeriesValues - 1, (int)std::floor(from));
+        const int end   = juce::jlimit(start + 1, numSeriesValues, (int)std::ceil(from + valuesPerColumn) + 1);
+
+        const juce::Range<float> range = getRange(level, start, end);
+        const float x = area.getX() + column + 0.5f;
+
+        if (p.isEmpty())
+            p.startNewSubPath(x, getY(range.getEnd()));
+        else
+            p.lineTo(x, getY(range.getEnd()));
+
+        p.lineTo(x, getY(range.getStart()));
+
+    }
+
+}
+
+juce::Range<float> HackAudio::Graph::DataSeries::getRange(int level, int start, int end) const
+{
+
+    if (level == 0)
+    {
+
+        float low, high;
+        juce::FloatVectorOperations::findMinAndMax(seriesValues + start, end - start, low, high);
+
+        return juce::Range<float>(low, high);
+
+    }
+
+    // Entry i of a level covers values i << level up to ((i + 1) << level) - 1
+    const juce::Range<float>* entries = pyramid + levelOffsets[level - 1];
+
+    const int first = start >> level;
+    const int last  = (end - 1) >> level;
+
+    juce::Range<float> range = entries[first];
+
+    for (int i = first + 1; i <= last; ++i)
+    {
+
+        range = range.getUnionWith(entries[i]);
+
+    }
+
+    return range;
+
+}
+
+HackAudio::Graph::ChangeAction::ChangeAction(HackAudio::Graph& graph, const juce::Array<HackAudio::Graph::Change>& changesToRecord)
+    : owner(&graph),
+      changes(changesToRecord)
+{
+
+    // Actions are recorded after the graph has already changed, so the first perform is a no-op
+    performed = false;
+
+}
+
+bool HackAudio::Graph::ChangeAction::perform()
+{
+
+    if (!performed)
+    {
+
+        performed = true;
+        return true;
+
+    }
+
+    return apply(true);
+
+}
+
+bool HackAudio::Graph::ChangeAction::undo()
+{
+
+    return apply(false);
+
+}
+
+int HackAudio::Graph::ChangeAction::getSizeInUnits()
+{
+
+    return (int)(sizeof(ChangeAction) + sizeof(Change) * changes.size());
+
+}
+
+juce::UndoableAction* HackAudio::Graph::ChangeAction::createCoalescedAction(juce::UndoableAction* nextAction)
+{
+
+    ChangeAction* next = dynamic_cast<ChangeAction*>(nextAction);
+
+    if (next == nullptr || owner.getComponent() == nullptr || next->owner.getComponent() != owner.getComponent())
+        return nullptr;
+
+    // Each node or point keeps its values from before the first change and after the last
+    ChangeAction* coalesced = new ChangeAction(*owner.getComponent(), changes);
+    coalesced->performed = true;
+
+    for (int i = 0; i < next->changes.size(); ++i)
+    {
+
+        const Change& change = next->changes.getReference(i);
+
+        int j = 0;
+
+        while (j < coalesced->changes.size() && coalesced->changes.getReference(j).index != change.index)
+        {
+
+            ++j;
+
+        }
+
+        if (j < coalesced->changes.size())
+            coalesced->changes.getReference(j).current = change.current;
+        else
+            coalesced->changes.add(change);
+
+    }
+
+    return coalesced;
+
+}
+
+bool HackAudio::Graph::ChangeAction::apply(bool useCurrentValues)
+{
+
+    HackAudio::Graph* graph = owner.getComponent();
+
+    if (graph == nullptr)
+        return false;
+
+    const juce::ScopedValueSetter<bool> paused(graph->journalPaused, true);
+
+    for (int i = 0; i < changes.size(); ++i)
+    {
+
+        const Change& change = changes.getReference(i);
+        const Breakpoint& values = (useCurrentValues) ? change.current : change.previous;
+
+        if (!graph->graphNodes.isEmpty())
+        {
+
+            if (change.index >= graph->graphNodes.size())
+                return false;
+
+            HackAudio::Graph::Node* n = graph->graphNodes[change.index];
+
+            n->setXValue(values.x);
+            n->setYValue(values.y);
+            n->setZValue(values.z);
+
+        }
+        else
+        {
+
+            if (change.index >= graph->graphPoints.size())
+                return false;
+
+            graph->setPoint(change.index, values.x, values.y, values.z);
+
+        }
+
+    }
+
+    return true;
+
+}
+
+HackAudio::Graph::StructureAction::StructureAction(HackAudio::Graph& graph, int index, const HackAudio::Graph::JournalEntry& journalEntry, bool wasInserted)
+    : owner(&graph),
+      entryIndex(index),
+      entry(journalEntry),
+      inserted(wasInserted)
+{
+
+    performed = false;
+
+}
+
+bool HackAudio::Graph::StructureAction::perform()
+{
+
+    if (!performed)
+    {
+
+        performed = true;
+        return true;
+
+    }
+
+    return (inserted) ? insertEntry() : removeEntry();
+
+}
+
+bool HackAudio::Graph::StructureAction::undo()
+{
+
+    return (inserted) ? removeEntry() : insertEntry();
+
+}
+
+int HackAudio::Graph::StructureAction::getSizeInUnits()
+{
+
+    return (int)(sizeof(StructureAction) + entry.nodeId.getNumBytesAsUTF8() + entry.tooltip.getNumBytesAsUTF8());
+
+}
+
+bool HackAudio::Graph::StructureAction::insertEntry()
+{
+
+    HackAudio::Graph* graph = owner.getComponent();
+
+    if (graph == nullptr)
+        return false;
+
+    const juce::ScopedValueSetter<bool> paused(graph->journalPaused, true);
+
+    if (!entry.isNode)
+    {
+
+        if (entryIndex > graph->graphPoints.size() || !graph->graphNodes.isEmpty())
+            return false;
+
+        graph->insertPoint(entryIndex, entry.values.x, entry.values.y, entry.values.z);
+        return true;
+
+    }
+
+    if (entryIndex > graph->graphNodes.size() || !graph->graphPoints.isEmpty())
+        return false;
+
+    HackAudio::Graph::Node* n = (entry.nodeId.isEmpty()) ? graph->insert(entryIndex) : graph->insert(entryIndex, entry.nodeId);
+
+    n->setXValue(entry.values.x);
+    n->setYValue(entry.values.y);
+    n->setZValue(entry.values.z);
+
+    n->setAxisLocking(entry.axisLockedY, entry.axisLockedX);
+    n->setValueDisplay(entry.displayValues);
+
+    if (!entry.displayValues)
+        n->setTooltip(entry.tooltip);
+
+    return true;
+
+}
+
+bool HackAudio::Graph::StructureAction::removeEntry()
+{
+
+    HackAudio::Graph* graph = owner.getComponent();
+
+    if (graph == nullptr)
+        return false;
+
+    const juce::ScopedValueSetter<bool> paused(graph->journalPaused, true);
+
+    if (!entry.isNode)
+    {
+
+        if (entryIndex >= graph->graphPoints.size())
+            return false;
+
+        graph->removePoint(entryIndex);
+        return true;
+
+    }
+
+    if (entryIndex >= graph->graphNodes.size())
+        return false;
+
+    graph->remove(entryIndex);
+    return true;
+
+}
+
+HackAudio::Graph::PointsAction::PointsAction(HackAudio::Graph& graph, const juce::Array<HackAudio::Graph::Breakpoint>& previousPoints, const juce::Array<HackAudio::Graph::Breakpoint>& currentPoints)
+    : owner(&graph),
+      previous(previousPoints),
+      current(currentPoints)
+{
+
+    performed = false;
+
+}
+
+bool HackAudio::Graph::PointsAction::perform()
+{
+
+    if (!performed)
+    {
+
+        performed = true;
+        return true;
+
+    }
+
+    return apply(current);
+
+}
+
+bool HackAudio::Graph::PointsAction::undo()
+{
+
+    return apply(previous);
+
+}
+
+int HackAudio::Graph::PointsAction::getSizeInUnits()
+{
+
+    return (int)(sizeof(PointsAction) + sizeof(Breakpoint) * (previous.size() + current.size()));
+
+}
+
+bool HackAudio::Graph::PointsAction::apply(const juce::Array<HackAudio::Graph::Breakpoint>& points)
+{
+
+    HackAudio::Graph* graph = owner.getComponent();
+
+    if (graph == nullptr || !graph->graphNodes.isEmpty())
+        return false;
+
+    const juce::ScopedValueSetter<bool> paused(graph->journalPaused, true);
+
+    graph->replacePoints(points);
+
+    return true;
+
+}
+
+HackAudio::Graph::Segment::Segment()
+{
+
+    valid = false;
+
+}
+
+HackAudio::Graph::Graph()
+{
+
+    setColour(HackAudio::backgroundColourId, HackAudio::Colours::Black);
+    setColour(HackAudio::midgroundColourId,  HackAudio::Colours::Gray);
+    setColour(HackAudio::foregroundColourId, HackAudio::Colours::White);
+    setColour(HackAudio::highlightColourId,  HackAudio::Colours::Cyan);
+
+    setWantsKeyboardFocus(false);
+    setMouseClickGrabsKeyboardFocus(false);
+
+    contentContainer.addMouseListener(this, false);
+    addAndMakeVisible(contentContainer);
+
+    nodeSize = 24;
+    lineWidth = 4.0f;
+
+    constraints.setSizeLimits(nodeSize, nodeSize, nodeSize, nodeSize);
+    constraints.setMinimumOnscreenAmounts(nodeSize, nodeSize, nodeSize, nodeSize);
+
+    startPoint = 0.5f;
+    endPoint   = 0.5f;
+    startValue = 0.5f;
+    endValue   = 0.5f;
+
+    pointNodeIndex    = -1;
+    pointNodeUpdating = false;
+
+    interpolationMode = Linear;
+
+    // The curve starts as a single segment from the start point to the end point, which nodes
+    // and points split in two as they're inserted
+    curveSegments.add(new Segment());
+
+    notificationInterval = 0;
+    startAndEndShown = true;
+
+    undoManager   = nullptr;
+    journalPaused = false;
+
+    realtimeReadBuffer       = nullptr;
+    realtimeGeneration       = 0;
+    realtimeReaderGeneration = 0;
+
+    spectrumMinDecibels = -90.0f;
+    spectrumMaxDecibels = 0.0f;
+    spectrumRefreshRate = 30;
+
+}
+
+HackAudio::Graph::~Graph()
+{
+
+    stopTimer();
+
+    spectrum = nullptr;
+
+    pointNode = nullptr;
+    graphNodes.clear();
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::add()
+{
+
+    jassert(graphPoints.isEmpty());   /* Warning: A Graph Can't Hold Both Nodes And Points */
+
+    flushChanges();
+    beginJournalTransaction();
+
+    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
+    n->addComponentListener(this);
+    graphNodes.add(n);
+
+    contentContainer.addAndMakeVisible(n);
+    n->setCentreRelative(0.5f, 0.5f);
+
+    nodeInserted(graphNodes.size() - 1);
+
+    recordStructure(n->index, true);
+
+    return n;
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::add(const juce::String& nodeId)
+{
+
+    jassert(graphPoints.isEmpty());   /* Warning: A Graph Can't Hold Both Nodes And Points */
+
+    flushChanges();
+    beginJournalTransaction();
+
+    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
+    n->setComponentID(nodeId);
+    n->addComponentListener(this);
+    graphNodes.add(n);
+
+    contentContainer.addAndMakeVisible(n);
+    n->setCentreRelative(0.5f, 0.5f);
+
+    nodeInserted(graphNodes.size() - 1);
+
+    recordStructure(n->index, true);
+
+    return n;
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::insert(int index)
+{
+
+    jassert(graphPoints.isEmpty());   /* Warning: A Graph Can't Hold Both Nodes And Points */
+
+    flushChanges();
+    beginJournalTransaction();
+
+    // Out of range indices append the node, as they do for the array
+    if (!juce::isPositiveAndBelow(index, graphNodes.size() + 1))
+        index = graphNodes.size();
+
+    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
+    n->addComponentListener(this);
+    graphNodes.insert(index, n);
+
+    contentContainer.addAndMakeVisible(n);
+    n->setCentreRelative(0.5f, 0.5f);
+
+    nodeInserted(index);
+
+    recordStructure(n->index, true);
+
+    return n;
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::insert(int index, const juce::String& nodeId)
+{
+
+    jassert(graphPoints.isEmpty());   /* Warning: A Graph Can't Hold Both Nodes And Points */
+
+    flushChanges();
+    beginJournalTransaction();
+
+    // Out of range indices append the node, as they do for the array
+    if (!juce::isPositiveAndBelow(index, graphNodes.size() + 1))
+        index = graphNodes.size();
+
+    HackAudio::Graph::Node* n = new HackAudio::Graph::Node(this);
+    n->setComponentID(nodeId);
+    n->addComponentListener(this);
+    graphNodes.insert(index, n);
+
+    contentContainer.addAndMakeVisible(n);
+    n->setCentreRelative(0.5f, 0.5f);
+
+    nodeInserted(index);
+
+    recordStructure(n->index, true);
+
+    return n;
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::getNode(int index) const
+{
+
+    return graphNodes[index];
+
+}
+
+HackAudio::Graph::Node* HackAudio::Graph::getNode(const juce::String& nodeId) const
+{
+
+    return (HackAudio::Graph::Node*)contentContainer.findChildWithID(nodeId);
+
+}
+
+void HackAudio::Graph::remove(int index)
+{
+
+    flushChanges();
+    beginJournalTransaction();
+    recordStructure(index, false);
+
+    graphNodes[index]->removeComponentListener(this);
+    graphNodes.remove(index);
+    nodeRemoved(index);
+
+}
+
+void HackAudio::Graph::remove(const juce::String& nodeId)
+{
+
+    flushChanges();
+
+    HackAudio::Graph::Node* n = (HackAudio::Graph::Node*)contentContainer.findChildWithID(nodeId);
+
+    beginJournalTransaction();
+
+    const int index = n->index;
+
+    recordStructure(index, false);
+
+    n->removeComponentListener(this);
+    graphNodes.remove(index);
+    nodeRemoved(index);
+
+}
+
+int HackAudio::Graph::addPoint(float x, float y, float z)
+{
+
+    insertPoint(graphPoints.size(), x, y, z);
+
+    return graphPoints.size() - 1;
+
+}
+
+void HackAudio::Graph::insertPoint(int index, float x, float y, float z)
+{
+
+    jassert(graphNodes.isEmpty());  /* Warning: A Graph Can't Hold Both Nodes And Points */
+    jassert(x >= 0.0f && x <= 1.0f && y >= 0.0f && y <= 1.0f);
+
+    flushChanges();
+    beginJournalTransaction();
+
+    index = juce::jlimit(0, graphPoints.size(), index);
+
+    const Breakpoint point = { x, y, z };
+    graphPoints.insert(index, point);
+
+    if (pointNodeIndex >= index)
+        ++pointNodeIndex;
+
+    curvePointInserted(index, x);
+
+    repaint(getPointArea(index));
+
+    recordStructure(index, true);
+
+}
+
+void HackAudio::Graph::setPoints(const juce::Array<HackAudio::Graph::Breakpoint>& points)
+{
+
+    jassert(graphNodes.isEmpty());  /* Warning: A Graph Can't Hold Both Nodes And Points */
+
+    flushChanges();
+    beginJournalTransaction();
+
+    for (int i = 0; i < points.size(); ++i)
+    {
+
+        const Breakpoint& point = points.getReference(i);
+
+        jassert(point.x >= 0.0f && point.x <= 1.0f && point.y >= 0.0f && point.y <= 1.0f);
+
+    }
+
+    // The old points are about to be replaced anyway, so they're moved out for the journal
+    // rather than copied
+    juce::Array<Breakpoint> previous;
+    previous.swapWith(graphPoints);
+
+    replacePoints(points);
+
+    recordPoints(previous);
+
+}
+
+void HackAudio::Graph::setPoint(int index, float x, float y, float z)
+{
+
+    jassert(x >= 0.0f && x <= 1.0f && y >= 0.0f && y <= 1.0f);
+
+    if (index < 0 || index >= graphPoints.size())
+        return;
+
+    const juce::Rectangle<int> previousArea = getPointArea(index);
+    const Breakpoint previous = graphPoints[index];
+
+    Breakpoint& point = graphPoints.getReference(index);
+    point.x = x;
+    point.y = y;
+    point.z = z;
+
+    if (index == pointNodeIndex)
+    {
+
+        showPointNode(index);
+
+    }
+
+    pointChanged(index, previousArea, previous);
+
+}
+
+HackAudio::Graph::Breakpoint HackAudio::Graph::getPoint(int index) const
+{
+
+    return graphPoints[index];
+
+}
+
+void HackAudio::Graph::removePoint(int index)
+{
+
+    if (index < 0 || index >= graphPoints.size())
+        return;
+
+    flushChanges();
+    beginJournalTransaction();
+    recordStructure(index, false);
+
+    if (index == pointNodeIndex)
+    {
+
+        hidePointNode();
+
+    }
+    else if (pointNodeIndex > index)
+    {
+
+        --pointNodeIndex;
+
+    }
+
+    const juce::Rectangle<int> previousArea = getPointArea(index);
+
+    graphPoints.remove(index);
+
+    curvePointRemoved(index, previousArea);
+
+}
+
+void HackAudio::Graph::clearPoints()
+{
+
+    if (graphPoints.isEmpty())
+        return;
+
+    flushChanges();
+    beginJournalTransaction();
+
+    juce::Array<Breakpoint> previous;
+    previous.swapWith(graphPoints);
+
+    replacePoints(juce::Array<Breakpoint>());
+
+    recordPoints(previous);
+
+}
+
+int HackAudio::Graph::getNumPoints() const
+{
+
+    return graphPoints.size();
+
+}
+
+int HackAudio::Graph::getNearestIndex(float x) const
+{
+
+    if (xIndex.isEmpty())
+        return -1;
+
+    const int position = findIndexPosition(x);
+
+    if (position == xIndex.size())
+        return xIndex.getLast().index;
+
+    if (position > 0 && x - xIndex.getReference(position - 1).x <= xIndex.getReference(position).x - x)
+        return xIndex.getReference(position - 1).index;
+
+    return xIndex.getReference(position).index;
+
+}
+
+int HackAudio::Graph::getInsertionIndex(float x) const
+{
+
+    const int position = findIndexPosition(x);
+
+    if (position == 0)
+        return 0;
+
+    return xIndex.getReference(position - 1).index + 1;
+
+}
+
+void HackAudio::Graph::setNodeSize(int newSize)
+{
+
+    jassert(nodeSize > 0);
+
+    nodeSize = newSize;
+
+    constraints.setSizeLimits(nodeSize, nodeSize, nodeSize, nodeSize);
+
+    // Resizing moves the nodes by a rounding error, which isn't an edit worth undoing
+    const juce::ScopedValueSetter<bool> paused(journalPaused, true);
+
+    for (int i = 0; i < graphNodes.size(); ++i)
+    {
+
+        HackAudio::Graph::Node* n = graphNodes[i];
+
+        float x = n->getXValue();
+        float y = n->getYValue();
+
+        n->setSize(nodeSize, nodeSize);
+
+        n->setXValue(x);
+        n->setYValue(y);
+
+    }
+
+}
+
+int HackAudio::Graph::getNodeSize() const
+{
+
+    return nodeSize;
+
+}
+
+void HackAudio::Graph::setLineWidth(float width)
+{
+
+    jassert(lineWidth > 0.0f);
+
+    lineWidth = width;
+    invalidateCurve();
+
+}
+
+float HackAudio::Graph::getLineWidth() const
+{
+
+    return lineWidth;
+
+}
+
+void HackAudio::Graph::setGraphPointStatus(bool shouldShowStartAndEndPoints)
+{
+
+    startAndEndShown = shouldShowStartAndEndPoints;
+    invalidateCurve();
+    publishBreakpoints();
+
+}
+
+bool HackAudio::Graph::getGraphPointStatus() const
+{
+
+    return startAndEndShown;
+
+}
+
+void HackAudio::Graph::setStartPoint(float pos)
+{
+
+    jassert(pos >= 0.0f && pos <= 1.0f);
+    startPoint = contentContainer.getY() + (pos * contentContainer.getHeight());
+    startValue = 1.0f - pos;
+    invalidateCurve();
+    publishBreakpoints();
+
+}
+
+float HackAudio::Graph::getStartPoint() const
+{
+
+    return startPoint;
+
+}
+
+void HackAudio::Graph::setEndPoint(float pos)
+{
+
+    jassert(pos >= 0.0f && pos <= 1.0f);
+    endPoint = contentContainer.getY() + (pos * contentContainer.getHeight());
+    endValue = 1.0f - pos;
+    invalidateCurve();
+    publishBreakpoints();
+
+}
+
+float HackAudio::Graph::getEndPoint() const
+{
+
+    return endPoint;
+
+}
+
+void HackAudio::Graph::setXRange(int min, int max)
+{
+
+    xmin = min;
+    xmax = max;
+
+    if (dataSeries)
+        repaint(contentContainer.getBounds());
+
+}
+
+void HackAudio::Graph::setXRange(float min, float max)
+{
+
+    xmin = min;
+    xmax = max;
+
+    if (dataSeries)
+        repaint(contentContainer.getBounds());
+
+}
+
+void HackAudio::Graph::setXRange(double min, double max)
+{
+
+    xmin = min;
+    xmax = max;
+
+    if (dataSeries)
+        repaint(contentContainer.getBounds());
+
+}
+
+juce::var HackAudio::Graph::getXMin() const
+{
+
+    return xmin;
+
+}
+
+juce::var HackAudio::Graph::getXMax() const
+{
+
+    return xmax;
+    
+}
+
+void HackAudio::Graph::setXUnits(const juce::String& units)
+{
+
+    xUnits = units;
+
+}
+
+juce::String HackAudio::Graph::getXUnits() const
+{
+
+    return xUnits;
+
+}
+
+void HackAudio::Graph::setYRange(int min, int max)
+{
+
+    ymin = min;
+    ymax = max;
+
+}
+
+void HackAudio::Graph::setYRange(float min, float max)
+{
+
+    ymin = min;
+    ymax = max;
+
+}
+
+void HackAudio::Graph::setYRange(double min, double max)
+{
+
+    ymin = min;
+    ymax = max;
+
+}
+
+juce::var HackAudio::Graph::getYMin() const
+{
+
+    return ymin;
+
+}
+
+juce::var HackAudio::Graph::getYMax() const
+{
+
+    return ymax;
+
+}
+
+void HackAudio::Graph::setYUnits(const juce::String& units)
+{
+
+    yUnits = units;
+
+}
+
+juce::String HackAudio::Graph::getYUnits() const
+{
+    
+    return yUnits;
+    
+}
+
+void HackAudio::Graph::setDataSeries(const float* values, int numValues, double firstX, double lastX)
+{
+
+    jassert(values != nullptr && numValues > 0);
+    jassert(firstX < lastX);
+
+    dataSeries.reset(new DataSeries(values, numValues, firstX, lastX));
+
+    setXRange(firstX, lastX);
+
+}
+
+void HackAudio::Graph::clearDataSeries()
+{
+
+    if (!dataSeries)
+        return;
+
+    dataSeries = nullptr;
+    dataSeriesPath.clear();
+
+    repaint(contentContainer.getBounds());
+
+}
+
+void HackAudio::Graph::setColourStatus(bool shouldSyncNodeColours)
+{
+
+    coloursSynced = shouldSyncNodeColours;
+    colourChanged();
+
+}
+
+void HackAudio::Graph::invalidateCurve()
+{
+
+    for (int i = 0; i < curveSegments.size(); ++i)
+    {
+
+        curveSegments[i]->valid = false;
+
+    }
+
+    repaint();
+
+}
+
+void HackAudio::Graph::setInterpolator(HackAudio::Graph::Interpolator newInterpolator)
+{
+
+    graphInterpolator = newInterpolator;
+    interpolationMode = (newInterpolator) ? Custom : Linear;
+
+    invalidateCurve();
+
+}
+
+void HackAudio::Graph::setInterpolationMode(HackAudio::Graph::InterpolationMode newMode)
+{
+
+    jassert(newMode != Custom);   /* Warning: Use setInterpolator For Custom Interpolation */
+
+    graphInterpolator = nullptr;
+    interpolationMode = newMode;
+
+    invalidateCurve();
+
+}
+
+HackAudio::Graph::InterpolationMode HackAudio::Graph::getInterpolationMode() const
+{
+
+    return interpolationMode;
+
+}
+
+float HackAudio::Graph::evaluate(const HackAudio::Graph::Breakpoint* breakpoints, int numBreakpoints, float x, HackAudio::Graph::InterpolationMode mode)
+{
+
+    if (numBreakpoints <= 0)
+        return 0.0f;
+
+    if (x <= breakpoints[0].x)
+        return breakpoints[0].y;
+
+    if (x >= breakpoints[numBreakpoints - 1].x)
+        return breakpoints[numBreakpoints - 1].y;
+
+    const Breakpoint* upper = std::upper_bound(breakpoints, breakpoints + numBreakpoints, x, [](float value, const Breakpoint& point)
+    {
+
+        return value < point.x;
+
+    });
+
+    const Breakpoint& from = upper[-1];
+    const Breakpoint& to   = upper[0];
+
+    if (isCubicInterpolation(mode))
+    {
+
+        float fromTangent, toTangent;
+        getCubicTangents(breakpoints, numBreakpoints, (int)(upper - breakpoints) - 1, mode, fromTangent, toTangent);
+
+        return evaluateCubic(from, to, fromTangent, toTangent, x);
+
+    }
+
+    const float width = to.x - from.x;
+
+    return (width > 0.0f) ? from.y + (to.y - from.y) * (x - from.x) / width : to.y;
+
+}
+
+HackAudio::Graph::Snapshot HackAudio::Graph::getSnapshot() const
+{
+
+    Snapshot snapshot;
+
+    snapshot.mode         = interpolationMode;
+    snapshot.interpolator = graphInterpolator;
+
+    snapshot.breakpoints.resize(getNumCurvePoints() + 2);
+    snapshot.breakpoints.resize(fillBreakpoints(snapshot.breakpoints.getRawDataPointer(), snapshot.breakpoints.size()));
+
+    return snapshot;
+
+}
+
+void HackAudio::Graph::setRealtimeCapacity(int maxBreakpoints)
+{
+
+    jassert(maxBreakpoints >= 0);
+
+    replaceRealtimeBuffer((maxBreakpoints > 0) ? new RealtimeBuffer<Breakpoint>(maxBreakpoints) : nullptr);
+
+}
+
+const HackAudio::Graph::Breakpoint* HackAudio::Graph::readRealtimeBreakpoints(int& numBreakpoints)
+{
+
+    // The generation is read before the buffer, so the one reported back is never newer than the
+    // buffer in use, and every buffer retired up to it is safe for the message thread to delete
+    const int generation = realtimeGeneration.load();
+
+    RealtimeBuffer<Breakpoint>* buffer = realtimeReadBuffer.load();
+
+    realtimeReaderGeneration.store(generation);
+
+    if (!buffer)
+    {
+
+        numBreakpoints = 0;
+        return nullptr;
+
+    }
+
+    return buffer->read(numBreakpoints);
+
+}
+
+void HackAudio::Graph::setSpectrumSource(double sampleRate, float minFrequency, float maxFrequency, int fftOrder)
+{
+
+    spectrum = nullptr;
+    spectrum.reset(new Spectrum(*this, sampleRate, minFrequency, maxFrequency, fftOrder));
+
+    spectrum->setRange(spectrumMinDecibels, spectrumMaxDecibels);
+    spectrum->setRefreshRate(spectrumRefreshRate);
+
+}
+
+void HackAudio::Graph::removeSpectrumSource()
+{
+
+    if (!spectrum)
+        return;
+
+    spectrum = nullptr;
+    repaint(contentContainer.getBounds());
+
+}
+
+void HackAudio::Graph::pushSpectrumSamples(const float* samples, int numSamples)
+{
+
+    if (Spectrum* s = spectrum.get())
+        s->push(samples, numSamples);
+
+}
+
+void HackAudio::Graph::setSpectrumRange(float minDecibels, float maxDecibels)
+{
+
+    jassert(minDecibels < maxDecibels);
+
+    spectrumMinDecibels = minDecibels;
+    spectrumMaxDecibels = maxDecibels;
+
+    if (spectrum)
+        spectrum->setRange(minDecibels, maxDecibels);
+
+}
+
+void HackAudio::Graph::setSpectrumRefreshRate(int framesPerSecond)
+{
+
+    jassert(framesPerSecond > 0);
+
+    spectrumRefreshRate = framesPerSecond;
+
+    if (spectrum)
+        spectrum->setRefreshRate(framesPerSecond);
+
+}
+
+juce::Path HackAudio::Graph::drawGraph(juce::Rectangle<int> graphBounds, juce::Point<int> start, juce::Point<int> end)
+{
+
+    return juce::Path();
+
+}
+
+void HackAudio::Graph::drawGraphBackground(juce::Graphics &g, juce::Rectangle<int> graphBounds)
+{
+
+    return;
+
+}
+
+juce::Path HackAudio::Graph::drawLineBetween(HackAudio::Graph::Node* nodeOne, Graph::Node* nodeTwo)
+{
+
+    juce::Path p;
+
+    juce::Point<int> n1 = nodeOne->getNodePosition();
+    juce::Point<int> n2 = nodeTwo->getNodePosition();
+
+    p.startNewSubPath(n1.getX(), n1.getY());
+    addInterpolatedLine(p, nodeOne->index, nodeTwo->index, n1, n2);
+
+    return p;
+
+}
+
+juce::Path HackAudio::Graph::drawLineFromStart(juce::Point<int> graphStart, HackAudio::Graph::Node* firstNode)
+{
+
+    juce::Path p;
+
+    juce::Point<int> n = firstNode->getNodePosition();
+
+    p.startNewSubPath(graphStart.getX(), graphStart.getY());
+    addInterpolatedLine(p, -1, firstNode->index, graphStart, n);
+
+    return p;
+
+}
+
+juce::Path HackAudio::Graph::drawLineToEnd(HackAudio::Graph::Node* lastNode, juce::Point<int> graphEnd)
+{
+
+    juce::Path p;
+
+    juce::Point<int> n = lastNode->getNodePosition();
+
+    p.startNewSubPath(n.getX(), n.getY());
+    addInterpolatedLine(p, lastNode->index, graphNodes.size(), n, graphEnd);
+
+    return p;
+    
+}
+
+void HackAudio::Graph::setNotificationInterval(int milliseconds)
+{
+
+    jassert(milliseconds >= 0);
+
+    // Changes batched under the old interval are delivered before switching
+    flushChanges();
+
+    notificationInterval = std::max(0, milliseconds);
+
+}
+
+int HackAudio::Graph::getNotificationInterval() const
+{
+
+    return notificationInterval;
+
+}
+
+void HackAudio::Graph::setUndoManager(juce::UndoManager* newUndoManager)
+{
+
+    undoManager = newUndoManager;
+
+}
+
+juce::UndoManager* HackAudio::Graph::getUndoManager() const
+{
+
+    return undoManager;
+
+}
+
+void HackAudio::Graph::addListener(HackAudio::Graph::Listener* listener)
+{
+
+    if (!listeners.contains(listener))
+    {
+
+        listeners.add(listener);
+
+    }
+
+}
+
+void HackAudio::Graph::removeListener(HackAudio::Graph::Listener* listener)
+{
+
+    listeners.remove(listener);
+
+}
+
+HackAudio::Graph::Breakpoint HackAudio::Graph::getBreakpoint(const HackAudio::Graph::Node* n) const
+{
+
+    const Breakpoint breakpoint = { n->getXValue(), n->getYValue(), n->getZValue() };
+
+    return breakpoint;
+
+}
+
+bool HackAudio::Graph::getCurveBreakpoint(int position, HackAudio::Graph::Breakpoint& breakpoint) const
+{
+
+    // Positions run through the nodes or points, with the start and end points either side
+    const int numItems = getNumCurvePoints();
+
+    if (position < 0 || position >= numItems)
+    {
+
+        if (!startAndEndShown || position < -1 || position > numItems)
+            return false;
+
+        breakpoint.x = (position < 0) ? 0.0f : 1.0f;
+        breakpoint.y = (position < 0) ? startValue : endValue;
+        breakpoint.z = 0.0f;
+
+        return true;
+
+    }
+
+    breakpoint = (graphNodes.isEmpty()) ? graphPoints.getReference(position) : getBreakpoint(graphNodes[position]);
+
+    return true;
+
+}
+
+bool HackAudio::Graph::getCurveNeighbour(int position, bool before, HackAudio::Graph::Breakpoint& breakpoint) const
+{
+
+    // Neighbours come from the X index, the same order a Snapshot evaluates in, rather than from
+    // the index order which differs once nodes have been dragged past each other
+    const int numItems = getNumCurvePoints();
+
+    int place = position;
+
+    if (position >= 0 && position < numItems)
+    {
+
+        place = findIndexPosition(indexedValues[position]);
+
+        while (xIndex.getReference(place).index != position)
+        {
+
+            ++place;
+
+        }
+
+    }
+
+    const int neighbour = place + ((before) ? -1 : 1);
+
+    if (neighbour < 0 || neighbour >= numItems)
+        return getCurveBreakpoint(neighbour, breakpoint);
+
+    return getCurveBreakpoint(xIndex.getReference(neighbour).index, breakpoint);
+
+}
+
+void HackAudio::Graph::addInterpolatedLine(juce::Path& p, int fromPosition, int toPosition, juce::Point<int> start, juce::Point<int> end) const
+{
+
+    Breakpoint from, to;
+
+    if (interpolationMode == Linear || !getCurveBreakpoint(fromPosition, from) || !getCurveBreakpoint(toPosition, to))
+    {
+
+        p.lineTo(end.getX(), end.getY());
+        return;
+
+    }
+
+    // The interpolated values are mapped back to pixels with the nodes' own Y scale
+    const float valueScale = contentContainer.getHeight() - nodeSize;
+
+    if (graphInterpolator)
+    {
+
+        // A custom interpolator is sampled every couple of pixels across the segment
+        const int numSteps = std::max(1, std::abs(end.getX() - start.getX()) / 2);
+
+        for (int i = 1; i < numSteps; ++i)
+        {
+
+            const float proportion = i / (float)numSteps;
+            const float y = graphInterpolator(from, to, proportion);
+
+            p.lineTo(start.getX() + (end.getX() - start.getX()) * proportion, start.getY() + (from.y - y) * valueScale);
+
+        }
+
+        p.lineTo(end.getX(), end.getY());
+        return;
+
+    }
+
+    Breakpoint previous, next;
+
+    const bool hasPrevious = getCurveNeighbour(fromPosition, true, previous);
+    const bool hasNext     = getCurveNeighbour(toPosition, false, next);
+
+    const float fromTangent = getCubicTangent((hasPrevious) ? &previous : nullptr, from, &to, interpolationMode);
+    const float toTangent   = getCubicTangent(&from, to, (hasNext) ? &next : nullptr, interpolationMode);
+
+    auto getY = [&](float t)
+    {
+
+        const float y = evaluateCubic(from, to, fromTangent, toTangent, from.x + (to.x - from.x) * t);
+
+        return start.getY() + (from.y - y) * valueScale;
+
+    };
+
+    // X is linear along the segment, so it's split in half until the curve is within a quarter
+    // of a pixel of a straight line at the middle and quarter points of every piece
+    const float width = (float)(end.getX() - start.getX());
+
+    float stack[16];
+    int   stackSize = 0;
+
+    float t0 = 0.0f;
+    float y0 = (float)start.getY();
+
+    stack[stackSize++] = 1.0f;
+
+    while (stackSize > 0)
+    {
+
+        const float t1 = stack[stackSize - 1];
+        const float y1 = (t1 < 1.0f) ? getY(t1) : (float)end.getY();
+
+        bool flat = true;
+
+        if (stackSize < 16 && std::abs(width) * (t1 - t0) > 2.0f)
+        {
+
+            for (int q = 1; q <= 3 && flat; ++q)
+            {
+
+                const float proportion = q * 0.25f;
+
+                flat = std::abs(getY(t0 + (t1 - t0) * proportion) - (y0 + (y1 - y0) * proportion)) <= 0.25f;
+
+            }
+
+        }
+
+        if (!flat)
+        {
+
+            stack[stackSize++] = (t0 + t1) * 0.5f;
+            continue;
+
+        }
+
+        p.lineTo(start.getX() + width * t1, y1);
+
+        t0 = t1;
+        y0 = y1;
+
+        --stackSize;
+
+    }
+
+}
+
+int HackAudio::Graph::fillBreakpoints(HackAudio::Graph::Breakpoint* destination, int maxBreakpoints) const
+{
+
+    int count = 0;
+
+    auto append = [&](const Breakpoint& breakpoint)
+    {
+
+        if (count < maxBreakpoints)
+            destination[count++] = breakpoint;
+
+    };
+
+    const int numEnds = (startAndEndShown) ? 2 : 0;
+
+    jassert(getNumCurvePoints() + numEnds <= maxBreakpoints);   /* Warning: Not Enough Room For Every Breakpoint */
+
+    if (startAndEndShown)
+    {
+
+        const Breakpoint start = { 0.0f, startValue, 0.0f };
+        append(start);
+
+    }
+
+    const int first = count;
+
+    for (int i = 0; i < graphNodes.size(); ++i)
+    {
+
+        append(getBreakpoint(graphNodes[i]));
+
+    }
+
+    for (int i = 0; i < graphPoints.size(); ++i)
+    {
+
+        append(graphPoints.getReference(i));
+
+    }
+
+    // An insertion sort, which is stable, doesn't allocate, and is close to linear for the
+    // nearly sorted orders graphs are usually in
+    for (int i = first + 1; i < count; ++i)
+    {
+
+        const Breakpoint breakpoint = destination[i];
+
+        int j = i;
+
+        while (j > first && destination[j - 1].x > breakpoint.x)
+        {
+
+            destination[j] = destination[j - 1];
+            --j;
+
+        }
+
+        destination[j] = breakpoint;
+
+    }
+
+    if (startAndEndShown)
+    {
+
+        const Breakpoint end = { 1.0f, endValue, 0.0f };
+        append(end);
+
+    }
+
+    return count;
+
+}
+
+void HackAudio::Graph::publishBreakpoints()
+{
+
+    if (!realtimeBreakpoints)
+        return;
+
+    deleteRetiredRealtimeBuffers();
+
+    const int numNeeded = getNumCurvePoints() + ((startAndEndShown) ? 2 : 0);
+
+    if (numNeeded > realtimeBreakpoints->getCapacity())
+    {
+
+        // Growing geometrically keeps a graph that's being built point by point from
+        // reallocating on every insert. The new buffer is published as it's swapped in
+        replaceRealtimeBuffer(new RealtimeBuffer<Breakpoint>(std::max(numNeeded, realtimeBreakpoints->getCapacity() * 2)));
+        return;
+
+    }
+
+    const int numBreakpoints = fillBreakpoints(realtimeBreakpoints->getWriteBuffer(), realtimeBreakpoints->getCapacity());
+
+    realtimeBreakpoints->publish(numBreakpoints);
+
+}
+
+void HackAudio::Graph::replaceRealtimeBuffer(RealtimeBuffer<Breakpoint>* newBuffer)
+{
+
+    if (realtimeBreakpoints)
+    {
+
+        // The reader may still be inside the old buffer, so it's kept until the reader has seen
+        // the generation that replaced it
+        RetiredRealtimeBuffer* retired = new RetiredRealtimeBuffer();
+        retired->buffer     = std::move(realtimeBreakpoints);
+        retired->generation = realtimeGeneration.load() + 1;
+
+        retiredRealtimeBuffers.add(retired);
+
+    }
+
+    realtimeBreakpoints.reset(newBuffer);
+
+    if (newBuffer)
+    {
+
+        const int numNeeded = getNumCurvePoints() + ((startAndEndShown) ? 2 : 0);
+
+        if (numNeeded > newBuffer->getCapacity())
+        {
+
+            realtimeBreakpoints.reset(new RealtimeBuffer<Breakpoint>(numNeeded));
+            newBuffer = realtimeBreakpoints.get();
+
+        }
+
+        newBuffer->publish(fillBreakpoints(newBuffer->getWriteBuffer(), newBuffer->getCapacity()));
+
+    }
+
+    realtimeReadBuffer.store(newBuffer);
+    ++realtimeGeneration;
+
+    deleteRetiredRealtimeBuffers();
+
+}
+
+void HackAudio::Graph::deleteRetiredRealtimeBuffers()
+{
+
+    const int seen = realtimeReaderGeneration.load();
+
+    for (int i = retiredRealtimeBuffers.size() - 1; i >= 0; --i)
+    {
+
+        if (retiredRealtimeBuffers[i]->generation <= seen)
+            retiredRealtimeBuffers.remove(i);
+
+    }
+
+}
+
+juce::Point<int> HackAudio::Graph::getPointPosition(const HackAudio::Graph::Breakpoint& point) const
+{
+
+    // The same placement as a Node's centre for the same X and Y values
+    const int width  = contentContainer.getWidth()  - nodeSize;
+    const int height = contentContainer.getHeight() - nodeSize;
+
+    return juce::Point<int>(
+        contentContainer.getX() + (nodeSize / 2) + (int)(width * point.x),
+        contentContainer.getY() + (nodeSize / 2) + (int)(height - height * point.y)
+    );
+
+}
+
+juce::Rectangle<int> HackAudio::Graph::getPointArea(int index) const
+{
+
+    if (index < 0 || index >= graphPoints.size())
+        return juce::Rectangle<int>();
+
+    return juce::Rectangle<int>(nodeSize, nodeSize).withCentre(getPointPosition(graphPoints.getReference(index))).expanded(1);
+
+}
+
+int HackAudio::Graph::getNumCurvePoints() const
+{
+
+    return graphNodes.size() + graphPoints.size();
+
+}
+
+juce::Path HackAudio::Graph::createSegmentPath(int index)
+{
+
+    const int numNodes = graphNodes.size();
+    const int numPoints = graphPoints.size();
+
+    if (numPoints > 0)
+    {
+
+        // Points have no Node to hand to the line drawing methods, so they're always joined
+        // with the graph's interpolation
+        if ((index == 0 || index == numPoints) && !startAndEndShown)
+            return juce::Path();
+
+        const juce::Point<int> fromPosition = (index > 0) ? getPointPosition(graphPoints.getReference(index - 1)) : juce::Point<int>(contentContainer.getX(), startPoint);
+        const juce::Point<int> toPosition   = (index < numPoints) ? getPointPosition(graphPoints.getReference(index)) : juce::Point<int>(contentContainer.getRight(), endPoint);
+
+        juce::Path p;
+        p.startNewSubPath(fromPosition.getX(), fromPosition.getY());
+        addInterpolatedLine(p, index - 1, index, fromPosition, toPosition);
+
+        return p;
+
+    }
+
+    if (index > 0 && index < numNodes)
+    {
+
+        return drawLineBetween(graphNodes[index - 1], graphNodes[index]);
+
+    }
+
+    if (!startAndEndShown || numNodes == 0)
+        return juce::Path();
+
+    if (index == 0)
+    {
+
+        return drawLineFromStart(juce::Point<int>(contentContainer.getX(), startPoint), graphNodes.getFirst());
+
+    }
+
+    return drawLineToEnd(graphNodes.getLast(), juce::Point<int>(contentContainer.getRight(), endPoint));
+
+}
+
+juce::Rectangle<int> HackAudio::Graph::updateSegment(int index)
+{
+
+    Segment* segment = curveSegments[index];
+
+    segment->path = createSegmentPath(index);
+
+    segment->outline.clear();
+    juce::PathStrokeType(lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded).createStrokedPath(segment->outline, segment->path);
+
+    segment->valid = true;
+
+    return segment->outline.getBounds().getSmallestIntegerContainer();
+
+}
+
+void HackAudio::Graph::nodeOrderChanged()
+{
+
+    for (int i = 0; i < graphNodes.size(); ++i)
+    {
+
+        HackAudio::Graph::Node* n = graphNodes[i];
+        n->setExplicitFocusOrder(i + 1);
+        n->index = i;
+
+    }
+
+    colourChanged();
+
+    rebuildIndex();
+
+    // The node values are cached so batched changes and the journal can report what each
+    // node changed from
+    nodeValues.clearQuick();
+
+    for (int i = 0; i < graphNodes.size(); ++i)
+    {
+
+        nodeValues.add(getBreakpoint(graphNodes[i]));
+
+    }
+
+    // One segment from the start point to the first node, one between each pair of nodes and
+    // one from the last node to the end point
+    curveSegments.clear();
+
+    for (int i = 0; i <= getNumCurvePoints(); ++i)
+    {
+
+        curveSegments.add(new Segment());
+
+    }
+
+    publishBreakpoints();
+
+    repaint();
+
+}
+
+void HackAudio::Graph::nodeInserted(int index)
+{
+
+    // Only the nodes after the new one change places
+    for (int i = index; i < graphNodes.size(); ++i)
+    {
+
+        HackAudio::Graph::Node* n = graphNodes[i];
+        n->setExplicitFocusOrder(i + 1);
+        n->index = i;
+
+    }
+
+    HackAudio::Graph::Node* n = graphNodes[index];
+
+    syncNodeColours(n);
+
+    nodeValues.insert(index, getBreakpoint(n));
+
+    curvePointInserted(index, n->getXValue());
+
+}
+
+void HackAudio::Graph::nodeRemoved(int index)
+{
+
+    for (int i = index; i < graphNodes.size(); ++i)
+    {
+
+        HackAudio::Graph::Node* n = graphNodes[i];
+        n->setExplicitFocusOrder(i + 1);
+        n->index = i;
+
+    }
+
+    nodeValues.remove(index);
+
+    // The removed node's component repaints the area it covered as it's deleted
+    curvePointRemoved(index, juce::Rectangle<int>());
+
+}
+
+void HackAudio::Graph::nodeChanged(HackAudio::Graph::Node* n)
+{
+
+    if (n == pointNode.get())
+    {
+
+        // The point node's Z value was set directly
+        if (pointNodeIndex >= 0)
+        {
+
+            const Breakpoint previous = graphPoints[pointNodeIndex];
+
+            graphPoints.getReference(pointNodeIndex).z = n->getZValue();
+            pointChanged(pointNodeIndex, getPointArea(pointNodeIndex), previous);
+
+        }
+
+        return;
+
+    }
+
+    const int index = n->index;
+
+    const bool reordered = (index >= 0) && updateIndex(index, n->getXValue());
+
+    // Crossing another node changes which segments take it as a cubic neighbour
+    if (reordered && isCubicInterpolation(interpolationMode))
+        invalidateCurve();
+    else
+        updateSegmentsAround(index);
+
+    publishBreakpoints();
+
+    if (index >= 0 && index < nodeValues.size())
+    {
+
+        const Breakpoint previous = nodeValues[index];
+        const Breakpoint current  = getBreakpoint(n);
+
+        nodeValues.set(index, current);
+
+        recordChange(index, previous, current);
+
+        if (notificationInterval > 0)
+        {
+
+            addChange(index, previous, current);
+            return;
+
+        }
+
+    }
+
+    listeners.call(&HackAudio::Graph::Listener::graphNodeChanged, this, n);
+
+}
+
+void HackAudio::Graph::curvePointInserted(int index, float x)
+{
+
+    insertIndex(index, x);
+
+    // The node or point splits the segment that ran across it in two, so only that one is
+    // replaced and the curve either side rebuilt, rather than every segment
+    curveSegments.insert(index, new Segment());
+
+    updateSegmentsAround(index);
+    publishBreakpoints();
+
+}
+
+void HackAudio::Graph::curvePointRemoved(int index, juce::Rectangle<int> previousArea)
+{
+
+    removeIndex(index);
+
+    // The segments either side of the node or point join up into one, so the second is
+    // dropped and only the joined segment and its cubic neighbours are rebuilt
+    juce::Rectangle<int> dirtyArea = previousArea;
+
+    Segment* dropped = curveSegments[index + 1];
+
+    if (dropped->valid)
+        dirtyArea = dirtyArea.getUnion(dropped->outline.getBounds().getSmallestIntegerContainer());
+
+    curveSegments.remove(index + 1);
+
+    const int reach = (isCubicInterpolation(interpolationMode)) ? 1 : 0;
+
+    dirtyArea = dirtyArea.getUnion(updateSegments(std::max(0, index - reach), std::min(curveSegments.size() - 1, index + reach)));
+
+    publishBreakpoints();
+
+    repaint(dirtyArea.expanded(1));
+
+}
+
+void HackAudio::Graph::replacePoints(const juce::Array<HackAudio::Graph::Breakpoint>& points)
+{
+
+    hidePointNode();
+
+    graphPoints = points;
+
+    nodeOrderChanged();
+
+}
+
+void HackAudio::Graph::pointChanged(int index, juce::Rectangle<int> previousArea, HackAudio::Graph::Breakpoint previous)
+{
+
+    if (updateIndex(index, graphPoints[index].x) && isCubicInterpolation(interpolationMode))
+        invalidateCurve();
+    else
+        updateSegmentsAround(index);
+
+    publishBreakpoints();
+
+    repaint(previousArea.getUnion(getPointArea(index)));
+
+    recordChange(index, previous, graphPoints[index]);
+
+    if (notificationInterval > 0)
+    {
+
+        addChange(index, previous, graphPoints[index]);
+        return;
+
+    }
+
+    listeners.call(&HackAudio::Graph::Listener::graphPointChanged, this, index);
+
+}
+
+void HackAudio::Graph::addChange(int index, const HackAudio::Graph::Breakpoint& previous, const HackAudio::Graph::Breakpoint& current)
+{
+
+    // A node that changes again within the batch keeps its original previous values
+    for (int i = 0; i < pendingChanges.size(); ++i)
+    {
+
+        Change& change = pendingChanges.getReference(i);
+
+        if (change.index == index)
+        {
+
+            change.current = current;
+            return;
+
+        }
+
+    }
+
+    const Change change = { index, previous, current };
+    pendingChanges.add(change);
+
+    if (!isTimerRunning())
+    {
+
+        startTimer(notificationInterval);
+
+    }
+
+}
+
+void HackAudio::Graph::flushChanges()
+{
+
+    stopTimer();
+
+    if (pendingChanges.isEmpty())
+        return;
+
+    // Listeners may change the graph again, which starts a new batch
+    juce::Array<Change> changes;
+    changes.swapWith(pendingChanges);
+
+    listeners.call(&HackAudio::Graph::Listener::graphChanged, this, changes);
 
 }
 
-void HackAudio::Graph::setYUnits(const juce::String& units)
+void HackAudio::Graph::timerCallback()
 {
 
-    yUnits = units;
+    flushChanges();
 
 }
 
-juce::String HackAudio::Graph::getYUnits() const
+HackAudio::Graph::JournalEntry HackAudio::Graph::getJournalEntry(int index) const
 {
-    
-    return yUnits;
-    
+
+    JournalEntry entry;
+
+    entry.isNode        = !graphNodes.isEmpty();
+    entry.axisLockedX   = false;
+    entry.axisLockedY   = false;
+    entry.displayValues = true;
+
+    if (entry.isNode)
+    {
+
+        HackAudio::Graph::Node* n = graphNodes[index];
+
+        entry.values        = getBreakpoint(n);
+        entry.nodeId        = n->getComponentID();
+        entry.axisLockedX   = n->axisLockedX;
+        entry.axisLockedY   = n->axisLockedY;
+        entry.displayValues = n->displayValues;
+
+        if (!n->displayValues)
+            entry.tooltip = n->getTooltip();
+
+    }
+    else
+    {
+
+        entry.values = graphPoints[index];
+
+    }
+
+    return entry;
+
 }
 
-void HackAudio::Graph::setColourStatus(bool shouldSyncNodeColours)
+void HackAudio::Graph::beginJournalTransaction()
 {
 
-    coloursSynced = shouldSyncNodeColours;
-    colourChanged();
+    if (undoManager && !journalPaused)
+        undoManager->beginNewTransaction();
 
 }
 
-juce::Path HackAudio::Graph::drawGraph(juce::Rectangle<int> graphBounds, juce::Point<int> start, juce::Point<int> end)
+void HackAudio::Graph::recordChange(int index, const HackAudio::Graph::Breakpoint& previous, const HackAudio::Graph::Breakpoint& current)
 {
 
-    return juce::Path();
+    if (!undoManager || journalPaused)
+        return;
+
+    juce::Array<Change> changes;
+
+    const Change change = { index, previous, current };
+    changes.add(change);
+
+    undoManager->perform(new ChangeAction(*this, changes));
 
 }
 
-void HackAudio::Graph::drawGraphBackground(juce::Graphics &g, juce::Rectangle<int> graphBounds)
+void HackAudio::Graph::recordStructure(int index, bool wasInserted)
 {
 
-    return;
+    if (!undoManager || journalPaused)
+        return;
+
+    undoManager->perform(new StructureAction(*this, index, getJournalEntry(index), wasInserted));
 
 }
 
-juce::Path HackAudio::Graph::drawLineBetween(HackAudio::Graph::Node* nodeOne, Graph::Node* nodeTwo)
+void HackAudio::Graph::recordPoints(const juce::Array<HackAudio::Graph::Breakpoint>& previous)
 {
 
-    juce::Path p;
+    if (!undoManager || journalPaused)
+        return;
 
-    juce::Point<int> n1 = nodeOne->getNodePosition();
-    juce::Point<int> n2 = nodeTwo->getNodePosition();
+    undoManager->perform(new PointsAction(*this, previous, graphPoints));
 
-    p.startNewSubPath(n1.getX(), n1.getY());
-    p.lineTo(n2.getX(), n2.getY());
+}
 
-    return p;
+juce::Rectangle<int> HackAudio::Graph::updateSegments(int first, int last)
+{
+
+    juce::Rectangle<int> dirtyArea;
+
+    for (int i = first; i <= last; ++i)
+    {
+
+        Segment* segment = curveSegments[i];
+
+        if (segment->valid)
+            dirtyArea = dirtyArea.getUnion(segment->outline.getBounds().getSmallestIntegerContainer());
+
+        dirtyArea = dirtyArea.getUnion(updateSegment(i));
+
+    }
+
+    return dirtyArea;
 
 }
 
-juce::Path HackAudio::Graph::drawLineFromStart(juce::Point<int> graphStart, HackAudio::Graph::Node* firstNode)
+void HackAudio::Graph::updateSegmentsAround(int index)
 {
 
-    juce::Path p;
+    if (index >= 0 && index + 1 < curveSegments.size())
+    {
 
-    juce::Point<int> n = firstNode->getNodePosition();
+        // Only the two segments either side of the node can have changed, or with cubic
+        // interpolation also the next ones out whose slopes depend on it, so only they are
+        // rebuilt and only the area they covered before and after is repainted
+        const int reach = (isCubicInterpolation(interpolationMode)) ? 1 : 0;
 
-    p.startNewSubPath(graphStart.getX(), graphStart.getY());
-    p.lineTo(n.getX(), n.getY());
+        const int first = std::max(0, index - reach);
+        const int last  = std::min(curveSegments.size() - 1, index + 1 + reach);
 
-    return p;
+        repaint(updateSegments(first, last).expanded(1));
+
+    }
 
 }
 
-juce::Path HackAudio::Graph::drawLineToEnd(HackAudio::Graph::Node* lastNode, juce::Point<int> graphEnd)
+void HackAudio::Graph::rebuildIndex()
 {
 
-    juce::Path p;
+    xIndex.clearQuick();
+    indexedValues.clearQuick();
 
-    juce::Point<int> n = lastNode->getNodePosition();
+    const int numItems = getNumCurvePoints();
 
-    p.startNewSubPath(n.getX(), n.getY());
-    p.lineTo(graphEnd.getX(), graphEnd.getY());
+    for (int i = 0; i < numItems; ++i)
+    {
+
+        const float x = (graphNodes.isEmpty()) ? graphPoints.getReference(i).x : graphNodes[i]->getXValue();
+
+        const IndexEntry entry = { x, i };
+
+        xIndex.add(entry);
+        indexedValues.add(x);
+
+    }
+
+    std::sort(xIndex.begin(), xIndex.end(), [](const IndexEntry& a, const IndexEntry& b)
+    {
+
+        return (a.x < b.x) || (a.x == b.x && a.index < b.index);
+
+    });
 
-    return p;
-    
 }
 
-void HackAudio::Graph::addListener(HackAudio::Graph::Listener* listener)
+void HackAudio::Graph::insertIndex(int index, float x)
 {
 
-    if (!listeners.contains(listener))
+    // Everything from the index on moves up one place before the new entry is slotted in
+    IndexEntry* entries = xIndex.getRawDataPointer();
+
+    for (int i = 0; i < xIndex.size(); ++i)
     {
 
-        listeners.add(listener);
+        if (entries[i].index >= index)
+            ++entries[i].index;
 
     }
 
+    const IndexEntry entry = { x, index };
+
+    const int position = (int)(std::lower_bound(xIndex.begin(), xIndex.end(), entry, [](const IndexEntry& a, const IndexEntry& b)
+    {
+
+        return (a.x < b.x) || (a.x == b.x && a.index < b.index);
+
+    }) - xIndex.begin());
+
+    xIndex.insert(position, entry);
+    indexedValues.insert(index, x);
+
 }
 
-void HackAudio::Graph::removeListener(HackAudio::Graph::Listener* listener)
+void HackAudio::Graph::removeIndex(int index)
 {
 
-    listeners.remove(listener);
+    IndexEntry* entries = xIndex.getRawDataPointer();
+
+    int position = findIndexPosition(indexedValues[index]);
+
+    while (entries[position].index != index)
+    {
+
+        ++position;
+
+    }
+
+    xIndex.remove(position);
+    indexedValues.remove(index);
+
+    // Everything after the index moves down one place to close the gap
+    entries = xIndex.getRawDataPointer();
+
+    for (int i = 0; i < xIndex.size(); ++i)
+    {
+
+        if (entries[i].index > index)
+            --entries[i].index;
+
+    }
 
 }
 
-void HackAudio::Graph::nodeOrderChanged()
+bool HackAudio::Graph::updateIndex(int index, float newX)
 {
 
-    for (int i = 0; i < graphNodes.size(); ++i)
+    if (index < 0 || index >= indexedValues.size())
+        return false;
+
+    const float oldX = indexedValues[index];
+
+    if (oldX == newX)
+        return false;
+
+    indexedValues.set(index, newX);
+
+    IndexEntry* entries = xIndex.getRawDataPointer();
+    const int numEntries = xIndex.size();
+
+    int position = findIndexPosition(oldX);
+
+    while (entries[position].index != index)
     {
 
-        HackAudio::Graph::Node* n = graphNodes[i];
-        n->setExplicitFocusOrder(i + 1);
+        ++position;
+
+    }
+
+    entries[position].x = newX;
+
+    const int oldPosition = position;
+
+    // The entry slides to its new place, which for a drag is usually no places at all
+    auto comesBefore = [](const IndexEntry& a, const IndexEntry& b)
+    {
+
+        return (a.x < b.x) || (a.x == b.x && a.index < b.index);
+
+    };
+
+    while (position > 0 && comesBefore(entries[position], entries[position - 1]))
+    {
+
+        std::swap(entries[position], entries[position - 1]);
+        --position;
+
+    }
+
+    while (position + 1 < numEntries && comesBefore(entries[position + 1], entries[position]))
+    {
+
+        std::swap(entries[position], entries[position + 1]);
+        ++position;
+
+    }
+
+    return position != oldPosition;
+
+}
+
+int HackAudio::Graph::findIndexPosition(float x) const
+{
+
+    return (int)(std::lower_bound(xIndex.begin(), xIndex.end(), x, [](const IndexEntry& entry, float value)
+    {
+
+        return entry.x < value;
+
+    }) - xIndex.begin());
+
+}
+
+void HackAudio::Graph::showPointNode(int index)
+{
+
+    if (!pointNode)
+    {
+
+        pointNode.reset(new Node(this));
+        pointNode->addComponentListener(this);
+        contentContainer.addChildComponent(pointNode.get());
         colourChanged();
 
     }
 
+    pointNodeIndex = index;
+
+    const Breakpoint& point = graphPoints.getReference(index);
+
+    // The node is placed from the point's values, so it mustn't write its rounded position back
+    const juce::ScopedValueSetter<bool> updating(pointNodeUpdating, true);
+
+    pointNode->setXValue(point.x);
+    pointNode->setYValue(point.y);
+    pointNode->z = point.z;
+
+    pointNode->setVisible(true);
+
 }
 
-void HackAudio::Graph::nodeChanged(HackAudio::Graph::Node* n)
+void HackAudio::Graph::hidePointNode()
 {
 
-    listeners.call(&HackAudio::Graph::Listener::graphNodeChanged, this, n);
+    pointNodeIndex = -1;
+
+    if (pointNode)
+    {
+
+        pointNode->setVisible(false);
+
+    }
 
 }
 
-void HackAudio::Graph::componentMovedOrResized(juce::Component& component, bool wasMoved, bool wasResized)
+void HackAudio::Graph::releasePointNode(HackAudio::Graph::Node* n)
 {
 
-    if (!wasMoved)
+    if (n != pointNode.get() || n->hasKeyboardFocus(false) || n->isMouseOverOrDragging())
         return;
 
-    for (int i = 0; i < graphNodes.size(); ++i)
+    hidePointNode();
+
+}
+
+void HackAudio::Graph::mouseMove(const juce::MouseEvent& e)
+{
+
+    if (graphPoints.isEmpty())
+        return;
+
+    if (pointNode && pointNode->hasKeyboardFocus(false))
+        return;
+
+    // Only the point under the mouse is given a node, which then handles the dragging
+    const juce::Point<int> position = e.getEventRelativeTo(this).getPosition();
+    const int radius = nodeSize / 2;
+
+    int   closest = -1;
+    float closestDistance = radius * radius + 1.0f;
+
+    // Only the points within a node's radius of the mouse along the X axis need checking
+    const float width   = (float)std::max(1, contentContainer.getWidth() - nodeSize);
+    const float centreX = (position.x - contentContainer.getX() - radius) / width;
+    const float reach   = (radius + 1) / width;
+
+    for (int p = findIndexPosition(centreX - reach); p < xIndex.size() && xIndex.getReference(p).x <= centreX + reach; ++p)
     {
 
-        juce::Component* c = dynamic_cast<juce::Component*>(graphNodes[i]);
+        const int i = xIndex.getReference(p).index;
+
+        const float distance = (float)getPointPosition(graphPoints.getReference(i)).getDistanceSquaredFrom(position);
 
-        if (c == &component)
+        if (distance < closestDistance)
         {
 
-            constraints.checkComponentBounds(c);
-            nodeChanged(graphNodes[i]);
-            repaint();
-            return;
+            closest = i;
+            closestDistance = distance;
 
         }
 
     }
 
+    if (closest >= 0)
+    {
+
+        if (closest != pointNodeIndex)
+            showPointNode(closest);
+
+    }
+    else
+    {
+
+        hidePointNode();
+
+    }
+
+}
+
+void HackAudio::Graph::componentMovedOrResized(juce::Component& component, bool wasMoved, bool wasResized)
+{
+
+    if (!wasMoved)
+        return;
+
+    if (&component == pointNode.get())
+    {
+
+        if (pointNodeUpdating || pointNodeIndex < 0)
+            return;
+
+        constraints.checkComponentBounds(pointNode.get());
+
+        const juce::Rectangle<int> previousArea = getPointArea(pointNodeIndex);
+        const Breakpoint previous = graphPoints[pointNodeIndex];
+
+        Breakpoint& point = graphPoints.getReference(pointNodeIndex);
+        point.x = pointNode->getXValue();
+        point.y = pointNode->getYValue();
+
+        pointChanged(pointNodeIndex, previousArea, previous);
+        return;
+
+    }
+
+    // Every node knows its own index, so there's no need to search for the one that moved
+    if (HackAudio::Graph::Node* n = dynamic_cast<HackAudio::Graph::Node*>(&component))
+    {
+
+        jassert(&n->owner == this);
+
+        constraints.checkComponentBounds(n);
+        nodeChanged(n);
+
+    }
+
 }
 
 void HackAudio::Graph::enablementChanged()
@@ -834,23 +3553,35 @@ void HackAudio::Graph::enablementChanged()
 
 }
 
-void HackAudio::Graph::colourChanged()
+void HackAudio::Graph::syncNodeColours(HackAudio::Graph::Node* n)
 {
 
     if (coloursSynced)
     {
 
-        for (int i = 0; i < graphNodes.size(); ++i)
-        {
+        n->setColour(HackAudio::backgroundColourId, findColour(HackAudio::backgroundColourId));
+        n->setColour(HackAudio::midgroundColourId, findColour(HackAudio::midgroundColourId));
+        n->setColour(HackAudio::foregroundColourId, findColour(HackAudio::foregroundColourId));
+        n->setColour(HackAudio::highlightColourId, findColour(HackAudio::highlightColourId));
+
+    }
 
-            HackAudio::Graph::Node* n = graphNodes[i];
+}
 
-            n->setColour(HackAudio::backgroundColourId, findColour(HackAudio::backgroundColourId));
-            n->setColour(HackAudio::midgroundColourId, findColour(HackAudio::midgroundColourId));
-            n->setColour(HackAudio::foregroundColourId, findColour(HackAudio::foregroundColourId));
-            n->setColour(HackAudio::highlightColourId, findColour(HackAudio::highlightColourId));
+void HackAudio::Graph::colourChanged()
+{
 
-        }
+    for (int i = 0; i < graphNodes.size(); ++i)
+    {
+
+        syncNodeColours(graphNodes[i]);
+
+    }
+
+    if (pointNode)
+    {
+
+        syncNodeColours(pointNode.get());
 
     }
 
@@ -879,57 +3610,76 @@ void HackAudio::Graph::paint(juce::Graphics& g)
 
     drawGraphBackground(g, contentContainer.getBounds());
 
-    g.setColour(findColour(HackAudio::foregroundColourId));
+    if (spectrum)
+    {
+
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        spectrum->paint(g, contentContainer.getBounds());
 
-    if (graphNodes.size() > 0)
+    }
+
+    if (dataSeries)
     {
 
-        if (startAndEndShown)
-        {
+        // The series uses the same inset as nodes, and only the columns being repainted are built
+        const juce::Rectangle<int> plotArea = contentContainer.getBounds().reduced(nodeSize / 2);
+        const juce::Rectangle<int> columns  = g.getClipBounds().expanded((int)std::ceil(lineWidth), 0).getIntersection(plotArea);
 
-            juce::Point<int> graphStart = juce::Point<int>(
-                contentContainer.getX(),
-                startPoint
-            );
+        const double visibleStart = (xmin.isVoid()) ? dataSeries->getFirstX() : (double)xmin;
+        const double visibleEnd   = (xmax.isVoid()) ? dataSeries->getLastX()  : (double)xmax;
+
+        jassert(visibleStart < visibleEnd);
 
-            HackAudio::Graph::Node* n = graphNodes.getFirst();
+        if (visibleStart < visibleEnd)
+        {
 
-            juce::Path interp = drawLineFromStart(graphStart, n);
+            dataSeries->createPath(dataSeriesPath, plotArea.toFloat(), visibleStart, visibleEnd, columns.getX() - plotArea.getX(), columns.getRight() - plotArea.getX());
 
-            g.strokePath(interp, juce::PathStrokeType(lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+            g.setColour(findColour(HackAudio::foregroundColourId));
+            g.strokePath(dataSeriesPath, juce::PathStrokeType(lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
 
         }
 
-        for (int i = 0; i < graphNodes.size(); ++i)
+    }
+
+    g.setColour(findColour(HackAudio::foregroundColourId));
+
+    if (getNumCurvePoints() > 0)
+    {
+
+        // Each segment's outline is stroked once when it changes, so painting is just a fill of
+        // the segments that overlap the area being repainted
+        const juce::Rectangle<int> clipBounds = g.getClipBounds();
+
+        for (int i = 0; i < curveSegments.size(); ++i)
         {
 
-            HackAudio::Graph::Node* n0 = graphNodes[i];
-            HackAudio::Graph::Node* n1 = graphNodes[i + 1];
+            Segment* segment = curveSegments[i];
 
-            juce::Path interp;
+            if (!segment->valid)
+                updateSegment(i);
 
-            if (n1)
-            {
+            if (clipBounds.intersects(segment->outline.getBounds().getSmallestIntegerContainer()))
+                g.fillPath(segment->outline);
 
-                interp = drawLineBetween(n0, n1);
+        }
 
-            }
-            else
-            {
+        // Lightweight points are drawn like a Node would draw itself
+        for (int i = 0; i < graphPoints.size(); ++i)
+        {
 
-                if (!startAndEndShown)
-                    return;
+            const juce::Rectangle<int> area = getPointArea(i);
 
-                juce::Point<int> graphEnd = juce::Point<int>(
-                    contentContainer.getRight(),
-                    endPoint
-                );
+            if (i == pointNodeIndex || !clipBounds.intersects(area))
+                continue;
 
-                interp = drawLineToEnd(n0, graphEnd);
+            const juce::Rectangle<float> bounds = area.reduced(1).toFloat();
 
-            }
+            g.setColour(findColour(HackAudio::backgroundColourId));
+            g.fillEllipse(bounds);
 
-            g.strokePath(interp, juce::PathStrokeType(lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+            g.setColour(findColour(HackAudio::foregroundColourId));
+            g.drawEllipse(bounds.reduced(2), lineWidth);
 
         }
 
@@ -1013,4 +3763,6 @@ void HackAudio::Graph::resized()
 
     contentContainer.centreWithSize(width - (CORNER_RADIUS * 2), height - (CORNER_RADIUS * 2));
 
+    invalidateCurve();
+
 }
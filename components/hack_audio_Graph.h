@@ -27,7 +27,8 @@ namespace HackAudio
  A component for using control points to manipulate a curve function
 */
 class Graph : public juce::Component,
-              private juce::ComponentListener
+              private juce::ComponentListener,
+              private juce::Timer
 {
 
 public:
@@ -145,10 +146,104 @@ public:
 
         float z;
 
+        int index;
+
         HackAudio::Graph& owner;
         
     };
 
+    /**
+     The X, Y and Z values of a single point on the graph's curve
+
+     @see HackAudio::Graph::Snapshot
+    */
+    struct Breakpoint
+    {
+        float x;    /**< The X value from 0.0 - 1.0 */
+        float y;    /**< The Y value from 0.0 - 1.0 */
+        float z;    /**< The Z value, 0.0 for the graph's start and end points */
+    };
+
+    /**
+     A change to one node or point's values, as delivered to batched listeners
+
+     @see HackAudio::Graph::setNotificationInterval
+    */
+    struct Change
+    {
+        int        index;       /**< The index of the node or point that changed */
+        Breakpoint previous;    /**< Its values before the first change in the batch */
+        Breakpoint current;     /**< Its values after the last change in the batch */
+    };
+
+    /**
+     Identifiers for the graph's built-in interpolation between breakpoints
+    */
+    enum InterpolationMode
+    {
+        Linear,         /**< Straight lines between breakpoints, the default */
+        CatmullRom,     /**< A smooth curve through every breakpoint */
+        MonotoneCubic,  /**< A smooth curve that never overshoots its breakpoints, for gains and envelopes */
+        Cardinal,       /**< Catmull-Rom with each breakpoint's Z value as its tension, from 0.0 (Catmull-Rom) to 1.0 (flat) */
+        Custom          /**< Custom is automatically assigned whenever an Interpolator is set */
+    };
+
+    /**
+     A function returning the curve's Y value at a proportion from 0.0 - 1.0 of the way between
+     two breakpoints. This may use their Z values in any way it likes
+
+     @see setInterpolator
+    */
+    typedef std::function<float (const Breakpoint& from, const Breakpoint& to, float proportion)> Interpolator;
+
+    /**
+     A copy of a graph's curve that can be evaluated on any thread, e.g. to fill a gain table or
+     a waveshaper's lookup table. The breakpoints are sorted by their X values, and the curve
+     holds the first and last breakpoints' Y values beyond them
+
+     @see HackAudio::Graph::getSnapshot
+    */
+    class Snapshot
+    {
+
+        friend class Graph;
+
+    public:
+
+        Snapshot();
+
+        /**
+         Returns the curve's Y value at the given X value
+        */
+        float evaluate(float x) const;
+
+        /**
+         Samples the curve at numSamples evenly spaced X values from 0.0 to 1.0 inclusive.
+         This never allocates, and straight segments are filled with vectorisable loops
+        */
+        void evaluate(float* destination, int numSamples) const;
+
+        /**
+         Returns the number of breakpoints in the snapshot, including the graph's start and end points
+        */
+        int getNumBreakpoints() const;
+
+        /**
+         Returns a breakpoint by its position in X order
+        */
+        Breakpoint getBreakpoint(int index) const;
+
+    private:
+
+        float interpolate(int index, float x) const;
+
+        juce::Array<Breakpoint> breakpoints;
+
+        InterpolationMode mode;
+        Interpolator interpolator;
+
+    };
+
     Graph();
     ~Graph();
 
@@ -205,6 +300,84 @@ public:
     */
     void remove(const juce::String& nodeId);
 
+    /**
+     Adds a lightweight point to the graph and returns its index.
+
+     Points are plain values stored by the graph rather than components, so graphs with hundreds
+     of them (automation lanes, drawn envelopes) stay cheap. The graph hit-tests and paints them
+     itself, and only the point under the mouse or with keyboard focus is given a Node to
+     interact with. A graph can hold either nodes or points, but not both, and its points are
+     always drawn with the graph's interpolation rather than the line drawing methods below
+
+     @param x   the point's X value from 0.0 - 1.0
+     @param y   the point's Y value from 0.0 - 1.0
+     @param z   the point's Z value
+
+     @see setInterpolationMode, setInterpolator
+    */
+    int addPoint(float x, float y, float z = 0.0f);
+
+    /**
+     Inserts a lightweight point at the given index. Only the curve either side of the new point
+     is rebuilt and repainted
+
+     @see addPoint
+    */
+    void insertPoint(int index, float x, float y, float z = 0.0f);
+
+    /**
+     Replaces all of the graph's points at once, e.g. with recorded automation. The curve is
+     rebuilt once, and the change is a single undoable action that's undone and redone with
+     one rebuild as well
+
+     @see addPoint
+    */
+    void setPoints(const juce::Array<Breakpoint>& points);
+
+    /**
+     Sets the X, Y and Z values of the point at the given index
+    */
+    void setPoint(int index, float x, float y, float z);
+
+    /**
+     Returns the values of the point at the given index
+    */
+    Breakpoint getPoint(int index) const;
+
+    /**
+     Removes the point at the given index. Only the curve either side of it is rebuilt and
+     repainted
+    */
+    void removePoint(int index);
+
+    /**
+     Removes all of the graph's points as a single undoable action
+    */
+    void clearPoints();
+
+    /**
+     Returns the number of lightweight points in the graph
+    */
+    int getNumPoints() const;
+
+    /**
+     Returns the index of the node or point with the X value closest to the given one, or -1
+     if the graph has neither. The graph keeps its nodes and points indexed by X value, so this
+     is a binary search rather than a scan
+
+     @param x   an X value from 0.0 - 1.0
+    */
+    int getNearestIndex(float x) const;
+
+    /**
+     Returns the index at which to insert a node or point with the given X value so that it
+     comes straight after the closest node or point to its left, e.g. for adding nodes where
+     the user clicks
+
+     @param x   an X value from 0.0 - 1.0
+    */
+    int getInsertionIndex(float x) const;
+
     /**
      Sets the size at which to draw the graph nodes
     */
@@ -263,6 +436,9 @@ public:
 
     /**
      Sets the numerical range for the X axis
+
+     When the graph shows a data series, this is also the part of the series that is visible,
+     so it can be used to zoom and pan
     */
     void setXRange(int min, int max);
     void setXRange(float min, float max);
@@ -315,6 +491,139 @@ public:
     */
     juce::String getYUnits() const;
 
+    /**
+     Sets how the default line drawing methods and evaluated snapshots join breakpoints.
+
+     The cubic modes share one set of maths for drawing and evaluating, and both take each
+     breakpoint's neighbours in X order, so while the nodes are in X order what's drawn is exactly
+     what a Snapshot or evaluate returns. Nodes dragged past each other are still drawn joined in
+     index order, where snapshots join them in X order. Drawn segments are subdivided until
+     they're within a quarter of a pixel of the true curve. This replaces any Interpolator
+
+     This defaults to Linear
+    */
+    void setInterpolationMode(InterpolationMode newMode);
+
+    /**
+     Returns the graph's interpolation mode
+    */
+    InterpolationMode getInterpolationMode() const;
+
+    /**
+     Returns the Y value at the given X value of a curve through breakpoints sorted by X, e.g.
+     those from readRealtimeBreakpoints. This is a binary search and one cubic, and never
+     allocates or locks, so it's safe to call from the audio thread. The Custom mode is
+     evaluated as Linear, since it needs the graph's Interpolator
+
+     @param breakpoints     the breakpoints, sorted by X
+     @param numBreakpoints  the number of breakpoints
+     @param x               the X value to evaluate
+     @param mode            the interpolation mode the breakpoints were drawn with
+    */
+    static float evaluate(const Breakpoint* breakpoints, int numBreakpoints, float x, InterpolationMode mode);
+
+    /**
+     Sets the function used to interpolate between breakpoints, both by the default line drawing
+     methods and by evaluated snapshots. This sets the interpolation mode to Custom, or back to
+     Linear if nullptr is passed.
+
+     The function is copied into every snapshot and may be called from other threads, so it
+     shouldn't depend on anything that can change while a snapshot is being evaluated
+    */
+    void setInterpolator(Interpolator newInterpolator);
+
+    /**
+     Returns a copy of the graph's current curve for evaluating, on this or any other thread.
+     This must be called on the message thread
+    */
+    Snapshot getSnapshot() const;
+
+    /**
+     Starts publishing the graph's breakpoints for the audio thread on every change, in the
+     same order and form as a Snapshot. This allocates room for maxBreakpoints breakpoints
+     (including the start and end points) on the message thread. Pass 0 to stop publishing
+
+     If the graph outgrows the capacity, a larger buffer is allocated on the message thread rather
+     than the curve being cut short. A buffer that's been replaced, or stopped with 0, is only
+     deleted once the reader has moved on from it, so this can be called while the audio thread
+     is reading
+
+     @see readRealtimeBreakpoints
+    */
+    void setRealtimeCapacity(int maxBreakpoints);
+
+    /**
+     Returns the most recently published breakpoints, sorted by X. This is wait-free and never
+     allocates or locks, but must only be called from a single thread at a time, e.g. the audio
+     callback, and not while the graph is being deleted. The returned breakpoints stay valid and
+     unchanged until the next call
+
+     @param numBreakpoints  set to the number of breakpoints returned
+    */
+    const Breakpoint* readRealtimeBreakpoints(int& numBreakpoints);
+
+    /**
+     Shows a live spectrum of the samples pushed with pushSpectrumSamples behind the graph's
+     curve, e.g. for an equalizer. The analysis runs on a background thread and the graph's
+     content area is repainted at most setSpectrumRefreshRate times a second.
+
+     Frequencies are spaced logarithmically from minFrequency at the graph's left edge to
+     maxFrequency at its right edge, to line up with a log-frequency X axis. This allocates,
+     so it must be called on the message thread before the audio thread starts pushing
+
+     @param sampleRate      the sample rate of the pushed samples
+     @param minFrequency    the frequency at the graph's left edge
+     @param maxFrequency    the frequency at the graph's right edge, up to half the sample rate
+     @param fftOrder        the base 2 logarithm of the FFT size, e.g. 11 for 2048 samples
+    */
+    void setSpectrumSource(double sampleRate, float minFrequency = 20.0f, float maxFrequency = 20000.0f, int fftOrder = 11);
+
+    /**
+     Stops showing the spectrum. The audio thread must have stopped pushing samples first
+    */
+    void removeSpectrumSource();
+
+    /**
+     Pushes a block of samples to the spectrum. This is wait-free and never allocates, so it
+     is safe to call from the audio callback. Samples that arrive faster than the background
+     thread can analyse them are dropped
+    */
+    void pushSpectrumSamples(const float* samples, int numSamples);
+
+    /**
+     Sets the levels shown at the bottom and top of the graph's content area
+
+     This defaults to -90.0f and 0.0f, where 0.0f is a full scale sine wave
+    */
+    void setSpectrumRange(float minDecibels, float maxDecibels);
+
+    /**
+     Sets the maximum number of times a second the spectrum is repainted
+
+     This defaults to 30
+    */
+    void setSpectrumRefreshRate(int framesPerSecond);
+
+    /**
+     Plots a large series of values as a line, e.g. an impulse response or a long automation
+     curve, behind the graph's curve. The values are copied and summarised into a pyramid of
+     minimums and maximums, so each repaint draws at most about two vertices per pixel of
+     width however many values there are and however far the graph is zoomed.
+
+     This sets the X range to the whole series, after which setXRange zooms and pans
+
+     @param values      the values to plot from 0.0 - 1.0, like a node's Y value
+     @param numValues   the number of values, which may be in the millions
+     @param firstX      the X axis value of the first value
+     @param lastX       the X axis value of the last value
+    */
+    void setDataSeries(const float* values, int numValues, double firstX, double lastX);
+
+    /**
+     Removes the data series from the graph
+    */
+    void clearDataSeries();
+
     /**
      Sets whether all nodes should share the same colour or not.
      If this is disabled, the user can manually colour nodes using different
@@ -322,6 +631,13 @@ public:
     */
     void setColourStatus(bool shouldSyncNodeColours);
 
+    /**
+     Discards the graph's cached curve and repaints it. The path returned by each of the line
+     drawing methods below is cached until a node next to it changes, so call this whenever
+     something else your overrides depend on changes
+    */
+    void invalidateCurve();
+
     /**
      Override to draw on the graph without using nodes
      
@@ -365,6 +681,19 @@ public:
         */
         virtual void graphNodeChanged(Graph*, Graph::Node*) = 0;
 
+        /**
+         Called when one of a graph's lightweight points has its X, Y, or Z values changed
+        */
+        virtual void graphPointChanged(Graph*, int pointIndex) {}
+
+        /**
+         Called with every change since the last call when the graph batches its notifications.
+         Each node or point appears at most once, with its values from before and after the batch
+
+         @see HackAudio::Graph::setNotificationInterval
+        */
+        virtual void graphChanged(Graph*, const juce::Array<Graph::Change>& changes) {}
+
     };
 
     /**
@@ -377,13 +706,412 @@ public:
     */
     void removeListener(Graph::Listener* listener);
 
+    /**
+     Sets how often listeners are notified of changes.
+
+     By default (an interval of 0) every change is delivered synchronously to graphNodeChanged or
+     graphPointChanged as it happens. With a positive interval, changes are accumulated instead
+     and delivered at most once per interval to graphChanged, so a fast drag costs one callback
+     per interval rather than one per mouse event. Any pending changes are delivered before nodes
+     or points are added or removed, so their indices are always current
+
+     @param milliseconds    the batching interval, e.g. 1000 / 60 for once per frame
+    */
+    void setNotificationInterval(int milliseconds);
+
+    /**
+     Returns the interval at which changes are batched, or 0 if listeners are notified synchronously
+    */
+    int getNotificationInterval() const;
+
+    /**
+     Records the graph's edits in an UndoManager so they can be undone and redone.
+
+     Each drag or arrow key press of a node or point, and each node or point added or removed,
+     starts a new transaction. Value changes within a transaction are coalesced into a single
+     action holding one delta per node or point changed, so a whole drag is one small entry
+     however many mouse events it took. Actions report their size in bytes, so the
+     UndoManager's maxNumberOfUnitsToKeep sets the journal's memory budget.
+
+     Undoing a removal recreates the node, so keep nodes by index or ComponentID rather than by
+     pointer, and make all edits through the graph while it's recording so the indices in the
+     journal stay valid. Pass nullptr to stop recording
+
+     @param newUndoManager  the UndoManager to record in, which the caller owns
+    */
+    void setUndoManager(juce::UndoManager* newUndoManager);
+
+    /**
+     Returns the UndoManager the graph records its edits in, or nullptr if it isn't recording
+    */
+    juce::UndoManager* getUndoManager() const;
+
 private:
 
+    /**
+     The values and settings needed to recreate a node or point that was removed
+    */
+    struct JournalEntry
+    {
+
+        Breakpoint   values;
+        juce::String nodeId;
+        juce::String tooltip;
+
+        bool isNode;
+        bool axisLockedX, axisLockedY;
+        bool displayValues;
+
+    };
+
+    /**
+     An undoable set of value changes with one delta per node or point, which the changes
+     made during a drag are coalesced into
+    */
+    class ChangeAction : public juce::UndoableAction
+    {
+
+    public:
+
+        ChangeAction(Graph& graph, const juce::Array<Change>& changesToRecord);
+
+        bool perform() override;
+        bool undo() override;
+
+        int getSizeInUnits() override;
+
+        juce::UndoableAction* createCoalescedAction(juce::UndoableAction* nextAction) override;
+
+    private:
+
+        bool apply(bool useCurrentValues);
+
+        juce::Component::SafePointer<Graph> owner;
+
+        juce::Array<Change> changes;
+
+        bool performed;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChangeAction)
+
+    };
+
+    /**
+     An undoable insertion or removal of a single node or point
+    */
+    class StructureAction : public juce::UndoableAction
+    {
+
+    public:
+
+        StructureAction(Graph& graph, int index, const JournalEntry& journalEntry, bool wasInserted);
+
+        bool perform() override;
+        bool undo() override;
+
+        int getSizeInUnits() override;
+
+    private:
+
+        bool insertEntry();
+        bool removeEntry();
+
+        juce::Component::SafePointer<Graph> owner;
+
+        int          entryIndex;
+        JournalEntry entry;
+
+        bool inserted;
+        bool performed;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StructureAction)
+
+    };
+
+    /**
+     An undoable replacement of all of the graph's points, which is applied with a single
+     rebuild of the curve rather than one per point
+    */
+    class PointsAction : public juce::UndoableAction
+    {
+
+    public:
+
+        PointsAction(Graph& graph, const juce::Array<Breakpoint>& previousPoints, const juce::Array<Breakpoint>& currentPoints);
+
+        bool perform() override;
+        bool undo() override;
+
+        int getSizeInUnits() override;
+
+    private:
+
+        bool apply(const juce::Array<Breakpoint>& points);
+
+        juce::Component::SafePointer<Graph> owner;
+
+        juce::Array<Breakpoint> previous;
+        juce::Array<Breakpoint> current;
+
+        bool performed;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PointsAction)
+
+    };
+
+    /**
+     A triple buffer with one writer and one reader, which always has a complete set of
+     elements to read that the writer isn't touching
+    */
+    template <typename ElementType>
+    class RealtimeBuffer
+    {
+
+    public:
+
+        RealtimeBuffer(int capacity);
+
+        ElementType* getWriteBuffer();
+        int getCapacity() const;
+
+        void publish(int numElements);
+
+        const ElementType* read(int& numElements);
+
+    private:
+
+        enum
+        {
+            newDataFlag = 4
+        };
+
+        juce::HeapBlock<ElementType> storage;
+        int sizes[3];
+
+        int bufferCapacity;
+
+        int writeIndex;
+        int readIndex;
+
+        std::atomic<int> sharedIndex;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeBuffer)
+
+    };
+
+    /**
+     The background thread shared by every graph's spectrum
+    */
+    class SpectrumThread : public juce::TimeSliceThread
+    {
+
+    public:
+
+        SpectrumThread();
+        ~SpectrumThread();
+
+    };
+
+    /**
+     Turns the samples pushed from the audio thread into smoothed levels in logarithmically
+     spaced bands on the SpectrumThread, and repaints the graph's content area when new levels
+     are ready
+    */
+    class Spectrum : public juce::TimeSliceClient,
+                     private juce::Timer
+    {
+
+    public:
+
+        Spectrum(Graph& graph, double sampleRate, float minFrequency, float maxFrequency, int fftOrder);
+        ~Spectrum();
+
+        void push(const float* samples, int numSamples);
+
+        void setRange(float minimum, float maximum);
+        void setRefreshRate(int framesPerSecond);
+
+        void paint(juce::Graphics& g, juce::Rectangle<int> area);
+
+    private:
+
+        enum
+        {
+            fifoSize = 16384,
+            numBands = 256
+        };
+
+        int  useTimeSlice() override;
+        void timerCallback() override;
+
+        void process(const float* samples, int numSamples);
+        void analyse();
+        void performFFT();
+
+        Graph& owner;
+
+        juce::AbstractFifo fifo;
+        juce::HeapBlock<float> fifoSamples;
+
+        int fftSize, hopSize;
+        int inputPosition, samplesUntilHop;
+
+        juce::HeapBlock<float> input;
+        juce::HeapBlock<float> window;
+        juce::HeapBlock<float> real, imaginary;
+        juce::HeapBlock<float> cosines, sines;
+        juce::HeapBlock<int>   bitReversed;
+        juce::HeapBlock<float> power;
+
+        juce::HeapBlock<int>   bandStart, bandEnd;
+        juce::HeapBlock<float> bandLevels, smoothedLevels;
+
+        float powerScale;
+        float hopSeconds;
+
+        std::atomic<float> minDecibels, maxDecibels;
+        std::atomic<bool>  updated;
+
+        RealtimeBuffer<float> levels;
+
+        juce::Path spectrumPath;
+
+        juce::SharedResourcePointer<SpectrumThread> spectrumThread;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Spectrum)
+
+    };
+
+    /**
+     A copy of a data series along with a pyramid of the minimum and maximum of every pair
+     of values, every pair of those pairs, and so on up to the whole series
+    */
+    class DataSeries
+    {
+
+    public:
+
+        DataSeries(const float* values, int numValues, double firstX, double lastX);
+
+        double getFirstX() const;
+        double getLastX() const;
+
+        void createPath(juce::Path& p, juce::Rectangle<float> area, double visibleStart, double visibleEnd, int firstColumn, int lastColumn) const;
+
+    private:
+
+        juce::Range<float> getRange(int level, int start, int end) const;
+
+        juce::HeapBlock<float> seriesValues;
+        int numSeriesValues;
+
+        double seriesFirstX, seriesLastX;
+
+        juce::HeapBlock<juce::Range<float>> pyramid;
+        juce::Array<int> levelOffsets;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DataSeries)
+
+    };
+
+    /**
+     A realtime buffer that's been replaced, kept until the reader has seen a later generation
+    */
+    struct RetiredRealtimeBuffer
+    {
+        std::unique_ptr<RealtimeBuffer<Breakpoint>> buffer;
+        int generation;
+    };
+
+    /**
+     A node or point's position in the graph's index of X values
+    */
+    struct IndexEntry
+    {
+        float x;
+        int   index;
+    };
+
+    /**
+     The cached path and stroked outline of the curve between two adjacent points, where the
+     graph's start and end points surround its nodes
+    */
+    struct Segment
+    {
+
+        Segment();
+
+        juce::Path path;
+        juce::Path outline;
+
+        bool valid;
+
+    };
+
+    Breakpoint getBreakpoint(const Graph::Node* n) const;
+
+    bool getCurveBreakpoint(int position, Breakpoint& breakpoint) const;
+    bool getCurveNeighbour(int position, bool before, Breakpoint& breakpoint) const;
+
+    int fillBreakpoints(Breakpoint* destination, int maxBreakpoints) const;
+
+    void publishBreakpoints();
+
+    void replaceRealtimeBuffer(RealtimeBuffer<Breakpoint>* newBuffer);
+    void deleteRetiredRealtimeBuffers();
+
+    void addInterpolatedLine(juce::Path& p, int fromPosition, int toPosition, juce::Point<int> start, juce::Point<int> end) const;
+
+    juce::Point<int> getPointPosition(const Breakpoint& point) const;
+    juce::Rectangle<int> getPointArea(int index) const;
+
+    int getNumCurvePoints() const;
+
+    juce::Path createSegmentPath(int index);
+    juce::Rectangle<int> updateSegment(int index);
+
     void nodeOrderChanged();
+    void nodeInserted(int index);
+    void nodeRemoved(int index);
     void nodeChanged(Graph::Node* n);
 
+    void curvePointInserted(int index, float x);
+    void curvePointRemoved(int index, juce::Rectangle<int> previousArea);
+
+    void replacePoints(const juce::Array<Breakpoint>& points);
+    void pointChanged(int index, juce::Rectangle<int> previousArea, Breakpoint previous);
+
+    void addChange(int index, const Breakpoint& previous, const Breakpoint& current);
+    void flushChanges();
+
+    void timerCallback() override;
+
+    JournalEntry getJournalEntry(int index) const;
+
+    void beginJournalTransaction();
+    void recordChange(int index, const Breakpoint& previous, const Breakpoint& current);
+    void recordStructure(int index, bool wasInserted);
+    void recordPoints(const juce::Array<Breakpoint>& previous);
+
+    juce::Rectangle<int> updateSegments(int first, int last);
+    void updateSegmentsAround(int index);
+
+    void rebuildIndex();
+    void insertIndex(int index, float x);
+    void removeIndex(int index);
+    bool updateIndex(int index, float newX);
+    int  findIndexPosition(float x) const;
+
+    void showPointNode(int index);
+    void hidePointNode();
+    void releasePointNode(Graph::Node* n);
+
+    void mouseMove(const juce::MouseEvent& e) override;
+
     void componentMovedOrResized(juce::Component& component, bool wasMoved, bool wasResized) override;
 
+    void syncNodeColours(Graph::Node* n);
+
     void enablementChanged() override;
     void colourChanged() override;
 
@@ -408,6 +1136,7 @@ private:
     float lineWidth;
 
     float startPoint, endPoint;
+    float startValue, endValue;
     bool  startAndEndShown;
 
     juce::var xmin, xmax;
@@ -418,8 +1147,45 @@ private:
 
     juce::OwnedArray<Node> graphNodes;
 
+    juce::OwnedArray<Segment> curveSegments;
+
+    juce::Array<Breakpoint> graphPoints;
+
+    juce::Array<IndexEntry> xIndex;
+    juce::Array<float>      indexedValues;
+
+    std::unique_ptr<Node> pointNode;
+    int  pointNodeIndex;
+    bool pointNodeUpdating;
+
+    InterpolationMode interpolationMode;
+    Interpolator      graphInterpolator;
+
+    std::unique_ptr<RealtimeBuffer<Breakpoint>> realtimeBreakpoints;    /**< Owned and written on the message thread */
+    std::atomic<RealtimeBuffer<Breakpoint>*>    realtimeReadBuffer;     /**< The buffer the reader takes from */
+
+    std::atomic<int> realtimeGeneration;        /**< Counts the buffers replaced so far */
+    std::atomic<int> realtimeReaderGeneration;  /**< The generation the reader last saw */
+
+    juce::OwnedArray<RetiredRealtimeBuffer> retiredRealtimeBuffers;
+
+    std::unique_ptr<DataSeries> dataSeries;
+    juce::Path dataSeriesPath;
+
+    std::unique_ptr<Spectrum> spectrum;
+    float spectrumMinDecibels, spectrumMaxDecibels;
+    int   spectrumRefreshRate;
+
     juce::ListenerList<Graph::Listener> listeners;
 
+    int notificationInterval;
+
+    juce::Array<Breakpoint> nodeValues;
+    juce::Array<Change>     pendingChanges;
+
+    juce::UndoManager* undoManager;
+    bool journalPaused;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Graph)
 
 };
@@ -26,362 +26,2180 @@ inline float clip(float x)
     return std::max(0.0f, std::min(1.0f, x));
 }
 
+inline bool isAnalysisCalibration(HackAudio::Meter::MeterCalibration calibration)
+{
+    return calibration == HackAudio::Meter::TruePeak
+        || calibration == HackAudio::Meter::Momentary
+        || calibration == HackAudio::Meter::ShortTerm;
+}
+
+// The thickness in pixels of the over indicator at the end of each channel
+static const int meterOverSize = 4;
+
+// How long in milliseconds a fed channel holds its last input once blocks stop arriving, long
+// enough to bridge the gap between large audio blocks at the display's refresh rate
+static const double meterFeedHoldTime = 100.0;
+
+// The 4x oversampling interpolation filter from ITU-R BS.1770-4 Annex 2, one row per phase
+static const float meterTruePeakCoefficients[4][12] =
+{
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+       0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+       0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+       0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+       0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+HackAudio::Meter::BlockSummary::BlockSummary()
+{
+
+    reset();
+
+}
+
+void HackAudio::Meter::BlockSummary::add(const float* samples, int count)
+{
+
+    for (int i = 0; i < count; ++i)
+    {
+
+        const float magnitude = std::abs(samples[i]);
+
+        peak = std::max(peak, magnitude);
+        sumOfMagnitudes += magnitude;
+        sumOfSquares    += magnitude * magnitude;
+
+    }
+
+    numSamples += count;
+
+}
+
+void HackAudio::Meter::BlockSummary::merge(const HackAudio::Meter::BlockSummary& other)
+{
+
+    peak = std::max(peak, other.peak);
+    sumOfMagnitudes += other.sumOfMagnitudes;
+    sumOfSquares    += other.sumOfSquares;
+    numSamples      += other.numSamples;
+
+}
+
+void HackAudio::Meter::BlockSummary::reset()
+{
+
+    peak            = 0.0f;
+    sumOfMagnitudes = 0.0f;
+    sumOfSquares    = 0.0f;
+    numSamples      = 0;
+
+}
+
+HackAudio::Meter::AnalysisThread::AnalysisThread() : juce::TimeSliceThread("HackAudio Meter Analysis")
+{
+
+}
+
+HackAudio::Meter::AnalysisThread::~AnalysisThread()
+{
+
+    stopThread(1000);
+
+}
+
+HackAudio::Meter::Analyser::Analyser()
+    : fifo(fifoSize),
+      fifoSamples(fifoSize),
+      history(maxBlockSize + numTaps - 1, true),
+      oversampled(maxBlockSize, true),
+      active(false),
+      truePeak(0.0f),
+      momentaryPower(0.0f),
+      shortTermPower(0.0f)
+{
+
+    analysisThread = nullptr;
+
+}
+
+HackAudio::Meter::Analyser::~Analyser()
+{
+
+    stop();
+
+}
+
+void HackAudio::Meter::Analyser::start(HackAudio::Meter::AnalysisThread& thread, double sampleRate)
+{
+
+    stop();
+
+    // K-weighting pre-filter (high shelf) and RLB filter (high pass) from ITU-R BS.1770,
+    // recomputed for the given sample rate
+    double f0 = 1681.974450955533;
+    double q  = 0.7071752369554196;
+    double k  = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+
+    const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+
+    double a0 = 1.0 + k / q + k * k;
+
+    shelfB[0] = (vh + vb * k / q + k * k) / a0;
+    shelfB[1] = 2.0 * (k * k - vh) / a0;
+    shelfB[2] = (vh - vb * k / q + k * k) / a0;
+    shelfA[0] = 1.0;
+    shelfA[1] = 2.0 * (k * k - 1.0) / a0;
+    shelfA[2] = (1.0 - k / q + k * k) / a0;
+
+    f0 = 38.13547087602444;
+    q  = 0.5003270373238773;
+    k  = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+    a0 = 1.0 + k / q + k * k;
+
+    highpassB[0] = 1.0;
+    highpassB[1] = -2.0;
+    highpassB[2] = 1.0;
+    highpassA[0] = 1.0;
+    highpassA[1] = 2.0 * (k * k - 1.0) / a0;
+    highpassA[2] = (1.0 - k / q + k * k) / a0;
+
+    shelfState[0]    = shelfState[1]    = 0.0;
+    highpassState[0] = highpassState[1] = 0.0;
+
+    subBlockLength = std::max(1, juce::roundToInt(sampleRate * 0.1));
+    subBlockCount  = 0;
+    subBlockIndex  = 0;
+    subBlockEnergy = 0.0;
+
+    for (int i = 0; i < numSubBlocks; ++i)
+    {
+
+        subBlockEnergies[i] = 0.0;
+
+    }
+
+    juce::FloatVectorOperations::clear(history, maxBlockSize + numTaps - 1);
+
+    // Only the consumer side of the FIFO is touched here, so the audio thread can keep pushing
+    fifo.finishedRead(fifo.getNumReady());
+
+    analysisThread = &thread;
+    active = true;
+
+    if (!thread.isThreadRunning())
+    {
+
+        thread.startThread();
+
+    }
+
+    thread.addTimeSliceClient(this);
+
+}
+
+void HackAudio::Meter::Analyser::stop()
+{
+
+    if (!analysisThread)
+        return;
+
+    active = false;
+
+    // This waits for any slice in progress, so the analyser can be safely destroyed afterwards
+    analysisThread->removeTimeSliceClient(this);
+    analysisThread = nullptr;
+
+    truePeak       = 0.0f;
+    momentaryPower = 0.0f;
+    shortTermPower = 0.0f;
+
+}
+
+void HackAudio::Meter::Analyser::push(const float* samples, int numSamples)
+{
+
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    // Samples that don't fit are dropped rather than blocking the audio thread
+    const int numToWrite = std::min(numSamples, fifo.getFreeSpace());
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numToWrite, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        juce::FloatVectorOperations::copy(fifoSamples + start1, samples, size1);
+
+    if (size2 > 0)
+        juce::FloatVectorOperations::copy(fifoSamples + start2, samples + size1, size2);
+
+    fifo.finishedWrite(size1 + size2);
+
+}
+
+float HackAudio::Meter::Analyser::getTruePeak()
+{
+
+    return truePeak.exchange(0.0f);
+
+}
+
+float HackAudio::Meter::Analyser::getMomentaryPower() const
+{
+
+    return momentaryPower.load();
+
+}
+
+float HackAudio::Meter::Analyser::getShortTermPower() const
+{
+
+    return shortTermPower.load();
+
+}
+
+int HackAudio::Meter::Analyser::useTimeSlice()
+{
+
+    if (!active)
+        return 100;
+
+    const int numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+        return 5;
+
+    const int numToRead = std::min(numReady, (int)maxBlockSize);
+
+    juce::ScopedNoDenormals noDenormals;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numToRead, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        process(fifoSamples + start1, size1);
+
+    if (size2 > 0)
+        process(fifoSamples + start2, size2);
+
+    fifo.finishedRead(size1 + size2);
+
+    return (numReady > numToRead) ? 0 : 5;
+
+}
+
+void HackAudio::Meter::Analyser::process(const float* samples, int numSamples)
+{
+
+    // True-peak: each phase of the 4x interpolation is a 12 tap FIR over the block, accumulated
+    // one tap at a time with the vectorised juce::FloatVectorOperations
+    juce::FloatVectorOperations::copy(history + (numTaps - 1), samples, numSamples);
+
+    float peak = 0.0f;
+
+    for (int phase = 0; phase < numPhases; ++phase)
+    {
+
+        juce::FloatVectorOperations::clear(oversampled, numSamples);
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+
+            juce::FloatVectorOperations::addWithMultiply(oversampled, history + (numTaps - 1 - tap), meterTruePeakCoefficients[phase][tap], numSamples);
+
+        }
+
+        float low, high;
+        juce::FloatVectorOperations::findMinAndMax(oversampled, numSamples, low, high);
+
+        peak = std::max(peak, std::max(-low, high));
+
+    }
+
+    std::memmove(history, history + numSamples, sizeof(float) * (numTaps - 1));
+
+    float current = truePeak.load();
+    while (peak > current && !truePeak.compare_exchange_weak(current, peak)) {}
+
+    // Loudness: K-weighted mean square over 100ms sub-blocks, combined into the 400ms momentary
+    // and 3s short-term windows whenever a sub-block completes
+    for (int i = 0; i < numSamples; ++i)
+    {
+
+        const double in = samples[i];
+
+        const double shelved = shelfB[0] * in + shelfState[0];
+        shelfState[0] = shelfB[1] * in - shelfA[1] * shelved + shelfState[1];
+        shelfState[1] = shelfB[2] * in - shelfA[2] * shelved;
+
+        const double weighted = highpassB[0] * shelved + highpassState[0];
+        highpassState[0] = highpassB[1] * shelved - highpassA[1] * weighted + highpassState[1];
+        highpassState[1] = highpassB[2] * shelved - highpassA[2] * weighted;
+
+        subBlockEnergy += weighted * weighted;
+
+        if (++subBlockCount < subBlockLength)
+            continue;
+
+        subBlockEnergies[subBlockIndex] = subBlockEnergy / subBlockLength;
+        subBlockIndex = (subBlockIndex + 1) % numSubBlocks;
+
+        subBlockEnergy = 0.0;
+        subBlockCount  = 0;
+
+        double momentary = 0.0;
+        double shortTerm = 0.0;
+
+        for (int block = 0; block < numSubBlocks; ++block)
+        {
+
+            const double energy = subBlockEnergies[(subBlockIndex + numSubBlocks - 1 - block) % numSubBlocks];
+
+            if (block < 4)
+                momentary += energy;
+
+            shortTerm += energy;
+
+        }
+
+        momentaryPower = (float)(momentary / 4.0);
+        shortTermPower = (float)(shortTerm / numSubBlocks);
+
+    }
+
+}
+
+HackAudio::Meter::ChannelState::ChannelState()
+{
+
+    sources       = nullptr;
+    outputs       = nullptr;
+    peaks         = nullptr;
+    levels        = nullptr;
+    targets       = nullptr;
+    paintedLevels = nullptr;
+    paintedPeaks  = nullptr;
+    paintedOvers  = nullptr;
+
+    numChannels = 0;
+    capacity    = 0;
+
+}
+
+int HackAudio::Meter::ChannelState::size() const
+{
+
+    return numChannels;
+
+}
+
+void HackAudio::Meter::ChannelState::setSize(int newSize)
+{
+
+    jassert(newSize >= 0);
+
+    if (newSize > capacity)
+    {
+
+        allocate(std::max(newSize, std::max(8, capacity * 2)));
+
+    }
+
+    for (int i = numChannels; i < newSize; ++i)
+    {
+
+        reset(i);
+
+    }
+
+    numChannels = newSize;
+
+}
+
+void HackAudio::Meter::ChannelState::reset(int channel)
+{
+
+    sources[channel]       = nullptr;
+    outputs[channel]       = 0.0f;
+    peaks[channel]         = 0.0f;
+    levels[channel]        = 0.0f;
+    targets[channel]       = 0.0f;
+    paintedLevels[channel] = -1;
+    paintedPeaks[channel]  = -1;
+    paintedOvers[channel]  = -1;
+
+}
+
+void HackAudio::Meter::ChannelState::clear()
+{
+
+    numChannels = 0;
+
+}
+
+void HackAudio::Meter::ChannelState::allocate(int newCapacity)
+{
+
+    // The lanes are laid out back to back, widest type first so each one stays aligned
+    const size_t bytesPerChannel = sizeof(float*) + sizeof(float) * 4 + sizeof(int) * 3;
+
+    juce::HeapBlock<char> newBlock(bytesPerChannel * newCapacity, true);
+
+    float** newSources       = reinterpret_cast<float**>(newBlock.getData());
+    float*  newOutputs       = reinterpret_cast<float*>(newSources + newCapacity);
+    float*  newPeaks         = newOutputs + newCapacity;
+    float*  newLevels        = newPeaks   + newCapacity;
+    float*  newTargets       = newLevels  + newCapacity;
+    int*    newPaintedLevels = reinterpret_cast<int*>(newTargets + newCapacity);
+    int*    newPaintedPeaks  = newPaintedLevels + newCapacity;
+    int*    newPaintedOvers  = newPaintedPeaks  + newCapacity;
+
+    if (numChannels > 0)
+    {
+
+        std::memcpy(newSources,       sources,       sizeof(float*) * numChannels);
+        std::memcpy(newOutputs,       outputs,       sizeof(float)  * numChannels);
+        std::memcpy(newPeaks,         peaks,         sizeof(float)  * numChannels);
+        std::memcpy(newLevels,        levels,        sizeof(float)  * numChannels);
+        std::memcpy(newTargets,       targets,       sizeof(float)  * numChannels);
+        std::memcpy(newPaintedLevels, paintedLevels, sizeof(int)    * numChannels);
+        std::memcpy(newPaintedPeaks,  paintedPeaks,  sizeof(int)    * numChannels);
+        std::memcpy(newPaintedOvers,  paintedOvers,  sizeof(int)    * numChannels);
+
+    }
+
+    block.swapWith(newBlock);
+
+    sources       = newSources;
+    outputs       = newOutputs;
+    peaks         = newPeaks;
+    levels        = newLevels;
+    targets       = newTargets;
+    paintedLevels = newPaintedLevels;
+    paintedPeaks  = newPaintedPeaks;
+    paintedOvers  = newPaintedOvers;
+
+    capacity = newCapacity;
+
+}
+
+HackAudio::Meter::History::History()
+    : active(false),
+      fifo(fifoSize),
+      bins(fifoSize),
+      binLength(1)
+{
+
+    binMin   = 0.0f;
+    binMax   = 0.0f;
+    binCount = 0;
+
+}
+
+void HackAudio::Meter::History::setSamplesPerBin(int samplesPerBin)
+{
+
+    binLength = std::max(1, samplesPerBin);
+
+}
+
+void HackAudio::Meter::History::push(const float* samples, int numSamples)
+{
+
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    const int length = binLength.load(std::memory_order_relaxed);
+
+    int position = 0;
+
+    while (position < numSamples)
+    {
+
+        const int count = std::min(numSamples - position, std::max(1, length - binCount));
+
+        float low, high;
+        juce::FloatVectorOperations::findMinAndMax(samples + position, count, low, high);
+
+        binMin = (binCount > 0) ? std::min(binMin, low)  : low;
+        binMax = (binCount > 0) ? std::max(binMax, high) : high;
+
+        binCount += count;
+        position += count;
+
+        if (binCount < length)
+            continue;
+
+        // Completed bins are dropped rather than blocking if the meter has stopped draining them
+        if (fifo.getFreeSpace() > 0)
+        {
+
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+            bins[(size1 > 0) ? start1 : start2] = juce::Range<float>(binMin, binMax);
+
+            fifo.finishedWrite(size1 + size2);
+
+        }
+
+        binCount = 0;
+
+    }
+
+}
+
+int HackAudio::Meter::History::pull(juce::Range<float>* destination, int maxBins)
+{
+
+    const int numToRead = std::min(fifo.getNumReady(), maxBins);
+
+    if (numToRead <= 0)
+        return 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numToRead, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        destination[i] = bins[start1 + i];
+
+    for (int i = 0; i < size2; ++i)
+        destination[size1 + i] = bins[start2 + i];
+
+    fifo.finishedRead(size1 + size2);
+
+    return size1 + size2;
+
+}
+
+HackAudio::Meter::StatisticsCounter::StatisticsCounter()
+    : overThreshold(1.0f),
+      overLength(1),
+      numOvers(0),
+      maxLevel(0.0f),
+      samplesAboveThreshold(0)
+{
+
+    runLength = 0;
+
+}
+
+void HackAudio::Meter::StatisticsCounter::setThreshold(float threshold, int consecutiveSamples)
+{
+
+    overThreshold = threshold;
+    overLength    = consecutiveSamples;
+
+}
+
+void HackAudio::Meter::StatisticsCounter::push(const float* samples, int numSamples)
+{
+
+    if (numSamples <= 0)
+        return;
+
+    const float threshold = overThreshold.load(std::memory_order_relaxed);
+    const int   length    = overLength.load(std::memory_order_relaxed);
+
+    float low, high;
+    juce::FloatVectorOperations::findMinAndMax(samples, numSamples, low, high);
+
+    const float peak = std::max(-low, high);
+
+    float current = maxLevel.load();
+    while (peak > current && !maxLevel.compare_exchange_weak(current, peak)) {}
+
+    // Most blocks never reach the threshold, so they skip the per-sample scan entirely
+    if (peak < threshold)
+    {
+
+        runLength = 0;
+        return;
+
+    }
+
+    int overs = 0;
+    int above = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+
+        if (std::abs(samples[i]) >= threshold)
+        {
+
+            ++above;
+
+            if (++runLength == length)
+                ++overs;
+
+        }
+        else
+        {
+
+            runLength = 0;
+
+        }
+
+    }
+
+    // The counters are only ever added to here, so a reset from the message thread is never lost
+    if (overs > 0)
+        numOvers.fetch_add(overs);
+
+    samplesAboveThreshold.fetch_add(above);
+
+}
+
+void HackAudio::Meter::StatisticsCounter::reset()
+{
+
+    numOvers              = 0;
+    maxLevel              = 0.0f;
+    samplesAboveThreshold = 0;
+
+}
+
+int HackAudio::Meter::StatisticsCounter::getNumOvers() const
+{
+
+    return numOvers.load();
+
+}
+
+float HackAudio::Meter::StatisticsCounter::getMaxLevel() const
+{
+
+    return maxLevel.load();
+
+}
+
+juce::int64 HackAudio::Meter::StatisticsCounter::getSamplesAboveThreshold() const
+{
+
+    return samplesAboveThreshold.load();
+
+}
+
+HackAudio::Meter::SampleFeed::SampleFeed(int fifoSize) : fifo(fifoSize), summaries(fifoSize)
+{
+
+    lastBlockTime = 0.0;
+
+}
+
+void HackAudio::Meter::SampleFeed::push(const float* samples, int numSamples)
+{
+
+    analyser.push(samples, numSamples);
+    history.push(samples, numSamples);
+    statistics.push(samples, numSamples);
+
+    pending.add(samples, numSamples);
+
+    // If the meter hasn't drained the FIFO yet, the summary stays pending and is merged with the
+    // next block so no peaks are lost and the producer never has to wait
+    if (fifo.getFreeSpace() == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+
+        summaries[start1] = pending;
+
+    }
+    else if (size2 > 0)
+    {
+
+        summaries[start2] = pending;
+
+    }
+
+    fifo.finishedWrite(size1 + size2);
+
+    pending.reset();
+
+}
+
+bool HackAudio::Meter::SampleFeed::pull(HackAudio::Meter::BlockSummary& result)
+{
+
+    const int numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        result.merge(summaries[start1 + i]);
+
+    for (int i = 0; i < size2; ++i)
+        result.merge(summaries[start2 + i]);
+
+    fifo.finishedRead(size1 + size2);
+
+    return result.numSamples > 0;
+
+}
+
+HackAudio::Meter::Scheduler::Scheduler()
+{
+
+    lastTick = 0.0;
+
+    #if JUCE_MAJOR_VERSION >= 7
+    vblankMeter = nullptr;
+    #endif
+
+}
+
+HackAudio::Meter::Scheduler::~Scheduler()
+{
+
+    stopTimer();
+
+}
+
+void HackAudio::Meter::Scheduler::add(HackAudio::Meter* meter)
+{
+
+    meters.addIfNotAlreadyThere(meter);
+
+    if (!isTimerRunning())
+    {
+
+        startTimerHz(ANIMATION_FPS);
+
+    }
+
+    #if JUCE_MAJOR_VERSION >= 7
+    attachToDisplay();
+    #endif
+
+}
+
+void HackAudio::Meter::Scheduler::remove(HackAudio::Meter* meter)
+{
+
+    meters.removeFirstMatchingValue(meter);
+
+    if (meters.isEmpty())
+    {
+
+        stopTimer();
+
+    }
+
+    #if JUCE_MAJOR_VERSION >= 7
+    attachToDisplay();
+    #endif
+
+}
+
+void HackAudio::Meter::Scheduler::tick()
+{
+
+    lastTick = juce::Time::getMillisecondCounterHiRes();
+
+    for (int i = 0; i < meters.size(); ++i)
+    {
+
+        meters.getUnchecked(i)->refresh();
+
+    }
+
+}
+
+void HackAudio::Meter::Scheduler::timerCallback()
+{
+
+    #if JUCE_MAJOR_VERSION >= 7
+    // The timer only drives the meters while the display isn't delivering vertical blanks,
+    // e.g. before the first meter is on screen
+    if (juce::Time::getMillisecondCounterHiRes() - lastTick < 1500.0 / ANIMATION_FPS)
+        return;
+    #endif
+
+    tick();
+
+}
+
+#if JUCE_MAJOR_VERSION >= 7
+void HackAudio::Meter::Scheduler::attachToDisplay()
+{
+
+    Meter* target = meters.getFirst();
+
+    if (target == vblankMeter)
+        return;
+
+    vblank.reset();
+    vblankMeter = target;
+
+    if (target)
+    {
+
+        vblank = std::make_unique<juce::VBlankAttachment>(target, [this]()
+        {
+
+            // Vertical blanks can arrive faster than ANIMATION_FPS, which the ballistics are tuned for
+            if (juce::Time::getMillisecondCounterHiRes() - lastTick >= 900.0 / ANIMATION_FPS)
+                tick();
+
+        });
+
+    }
+
+}
+#endif
+
 HackAudio::Meter::Meter()
 {
 
-    setColour(HackAudio::backgroundColourId, HackAudio::Colours::Black);
-    setColour(HackAudio::midgroundColourId, HackAudio::Colours::Gray);
-    setColour(HackAudio::foregroundColourId, HackAudio::Colours::White);
-    setColour(HackAudio::highlightColourId, HackAudio::Colours::Cyan);
+    setColour(HackAudio::backgroundColourId, HackAudio::Colours::Black);
+    setColour(HackAudio::midgroundColourId, HackAudio::Colours::Gray);
+    setColour(HackAudio::foregroundColourId, HackAudio::Colours::White);
+    setColour(HackAudio::highlightColourId, HackAudio::Colours::Cyan);
+
+    setWantsKeyboardFocus(false);
+
+    pipsShown = true;
+
+    pipSize = 4;
+
+    pipLocations.resize(10);
+
+    meterSkewFactor = 0.0;
+
+    meterPeakStatus = false;
+    currentPeakPos = 0.0;
+
+    meterStyle = Vertical;
+
+    meterRise = 0;
+    meterOvershoot = 0.0f;
+    meterFall = 0;
+
+    meterCalibration = Custom;
+
+    meterSampleRate = 44100.0;
+
+    chromeScale = 1.0f;
+
+    overThreshold = 1.0f;
+    overLength    = 1;
+
+    historyShown   = false;
+    historySeconds = 5.0;
+
+#if JUCE_DEBUG
+    pushesInProgress = 0;
+#endif
+
+    updateCoefficients();
+
+}
+
+HackAudio::Meter::~Meter()
+{
+
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Meter Deleted While The Audio Thread Is Pushing To It */
+#endif
+
+    scheduler->remove(this);
+
+    meterFeeds.clear();
+
+}
+
+void HackAudio::Meter::setMeterStyle(HackAudio::Meter::MeterStyle style)
+{
+
+    meterStyle = style;
+    resized();
+    repaint();
+
+}
+
+HackAudio::Meter::MeterStyle HackAudio::Meter::getMeterStyle() const
+{
+
+    return meterStyle;
+
+}
+
+void HackAudio::Meter::setMeterCalibration(HackAudio::Meter::MeterCalibration calibration)
+{
+
+    switch (calibration)
+    {
+        case Peak:
+            setRiseTime(10);
+            setFallTime(1500);
+            setOvershoot(0);
+            setPeakStatus(false);
+            break;
+
+        case RMS:
+            setRiseTime(10);
+            setPeakStatus(true);
+            break;
+
+        case VU:
+            setRiseTime(300);
+            setOvershoot(1.25);
+            setFallTime(300);
+            setPeakStatus(true);
+            break;
+
+        case TruePeak:
+            setRiseTime(0);
+            setFallTime(1500);
+            setOvershoot(0);
+            setPeakStatus(true);
+            break;
+
+        case Momentary:
+        case ShortTerm:
+            setRiseTime(0);
+            setFallTime(0);
+            setOvershoot(0);
+            setPeakStatus(true);
+            break;
+
+        default:
+            break;
+    }
+
+    meterCalibration = calibration;
+
+    updateAnalysis();
+
+}
+
+HackAudio::Meter::MeterCalibration HackAudio::Meter::getMeterCalibration() const
+{
+
+    return meterCalibration;
+
+}
+
+void HackAudio::Meter::setSource(int channel, float* const source)
+{
+
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Feeds Changed While The Audio Thread Is Pushing */
+#endif
+
+    ensureChannel(channel);
+
+    meterChannels.sources[channel] = source;
+    meterChannels.outputs[channel] = 0.0f;
+    meterFeeds.set(channel, nullptr);
+
+    scheduler->add(this);
+
+    updateHistory();
+    repaint();
+
+}
+
+void HackAudio::Meter::setSampleSource(int channel, int fifoSize)
+{
+
+    jassert(fifoSize > 0);
+
+    ensureChannel(channel);
+    createFeed(channel, fifoSize);
+
+    scheduler->add(this);
+
+    updateHistory();
+    repaint();
+
+}
+
+void HackAudio::Meter::pushSamples(int channel, const float* samples, int numSamples)
+{
+
+#if JUCE_DEBUG
+    ++pushesInProgress;
+#endif
+
+    SampleFeed* feed = meterFeeds[channel];
+
+    jassert(feed != nullptr);   /* Warning: Channel Was Not Set Up With setSampleSource */
+
+    if (feed)
+    {
+
+        feed->push(samples, numSamples);
+
+    }
+
+#if JUCE_DEBUG
+    --pushesInProgress;
+#endif
+
+}
+
+void HackAudio::Meter::setSampleSources(int numChannels, int fifoSize)
+{
+
+    jassert(numChannels > 0 && fifoSize > 0);
+
+    ensureChannel(numChannels - 1);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+
+        createFeed(i, fifoSize);
+
+    }
+
+    scheduler->add(this);
+
+    updateHistory();
+    repaint();
+
+}
+
+void HackAudio::Meter::pushSamples(const float* const* channelData, int numChannels, int numSamples)
+{
+
+    jassert(numChannels <= meterFeeds.size());  /* Warning: More Channels Than The Meter Was Set Up With */
+
+#if JUCE_DEBUG
+    ++pushesInProgress;
+#endif
+
+    const int count = std::min(numChannels, meterFeeds.size());
+
+    for (int i = 0; i < count; ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            feed->push(channelData[i], numSamples);
+
+        }
+
+    }
+
+#if JUCE_DEBUG
+    --pushesInProgress;
+#endif
+
+}
+
+void HackAudio::Meter::pushSamples(const juce::AudioBuffer<float>& buffer)
+{
+
+    pushSamples(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+
+}
+
+void HackAudio::Meter::pushInterleavedSamples(const float* samples, int numChannels, int numSamples)
+{
+
+    jassert(numChannels <= meterFeeds.size());  /* Warning: More Channels Than The Meter Was Set Up With */
+
+#if JUCE_DEBUG
+    ++pushesInProgress;
+#endif
+
+    const int count = std::min(numChannels, meterFeeds.size());
+
+    // Each channel is deinterleaved through a small buffer on the stack, so nothing is allocated
+    // on the audio thread regardless of the block size
+    const int chunkSize = 256;
+    float chunk[chunkSize];
+
+    for (int i = 0; i < count; ++i)
+    {
+
+        SampleFeed* feed = meterFeeds[i];
+
+        if (!feed)
+            continue;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+
+            const int numToCopy = std::min(chunkSize, numSamples - start);
+            const float* source = samples + (size_t)start * numChannels + i;
+
+            for (int j = 0; j < numToCopy; ++j)
+                chunk[j] = source[(size_t)j * numChannels];
+
+            feed->push(chunk, numToCopy);
+
+        }
+
+    }
+
+#if JUCE_DEBUG
+    --pushesInProgress;
+#endif
+
+}
+
+void HackAudio::Meter::setSampleRate(double sampleRate)
+{
+
+    jassert(sampleRate > 0.0);
+
+    meterSampleRate = sampleRate;
+
+    updateAnalysis();
+    updateHistory();
+
+}
+
+double HackAudio::Meter::getSampleRate() const
+{
+
+    return meterSampleRate;
+
+}
+
+float HackAudio::Meter::getMomentaryLoudness() const
+{
+
+    return getLoudness(false);
+
+}
+
+float HackAudio::Meter::getShortTermLoudness() const
+{
+
+    return getLoudness(true);
+
+}
+
+void HackAudio::Meter::clearSource(int channel)
+{
+
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Feeds Changed While The Audio Thread Is Pushing */
+#endif
+
+    if (!juce::isPositiveAndBelow(channel, meterChannels.size()))
+        return;
+
+    // The channel is emptied in place rather than removed, so no other channel's feed moves
+    meterChannels.reset(channel);
+    meterFeeds.set(channel, nullptr);
+
+    int numChannels = meterChannels.size();
+
+    while (numChannels > 0 && meterChannels.sources[numChannels - 1] == nullptr && meterFeeds[numChannels - 1] == nullptr)
+    {
+
+        --numChannels;
+
+    }
+
+    meterChannels.setSize(numChannels);
+    meterFeeds.removeRange(numChannels, meterFeeds.size() - numChannels);
+
+    if (numChannels == 0)
+    {
+
+        scheduler->remove(this);
+
+    }
+
+    updateHistory();
+    repaint();
+
+}
+
+void HackAudio::Meter::clearSources()
+{
+
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Feeds Changed While The Audio Thread Is Pushing */
+#endif
+
+    meterChannels.clear();
+    meterFeeds.clear();
+
+    scheduler->remove(this);
+
+    updateHistory();
+    
+}
+
+void HackAudio::Meter::setSkewFactor(double factor, bool symmetricSkew)
+{
+
+    meterSkewFactor = factor;
+
+}
+
+void HackAudio::Meter::setSkewFactorFromMidPoint(double meterValueToShowAtMidPoint)
+{
+
+}
+
+double HackAudio::Meter::getSkewFactor() const
+{
+
+    return meterSkewFactor;
+
+}
+
+void HackAudio::Meter::setPipState(bool shouldBeShown)
+{
+
+    pipsShown = shouldBeShown;
+    resized();
+    repaint();
+
+}
+
+bool HackAudio::Meter::getPipState() const
+{
+
+    return pipsShown;
+
+}
+
+void HackAudio::Meter::setPipCount(int count)
+{
+
+    pipLocations.resize(count);
+    resized();
+    repaint();
+
+}
+
+int HackAudio::Meter::getPipCount() const
+{
+
+    return pipLocations.size();
+
+}
+
+void HackAudio::Meter::setPeakStatus(bool shouldShowPeak)
+{
+
+    meterPeakStatus = shouldShowPeak;
+
+}
+
+bool HackAudio::Meter::getPeakStatus() const
+{
+
+    return meterPeakStatus;
+
+}
+
+void HackAudio::Meter::setRiseTime(int riseMs)
+{
+
+    jassert(riseMs >= 0);
+
+    meterRise = riseMs;
+    updateCoefficients();
+
+    meterCalibration = Custom;
+
+}
+
+int HackAudio::Meter::getRiseTime() const
+{
+
+    return meterRise;
+
+}
+
+void HackAudio::Meter::setOvershoot(float overshoot)
+{
+
+    jassert(overshoot >= 0.0f);
+
+    meterOvershoot = overshoot;
+
+    meterCalibration = Custom;
+
+}
+
+float HackAudio::Meter::getOvershoot() const
+{
+
+    return meterOvershoot;
+
+}
+
+void HackAudio::Meter::setFallTime(int fallMs)
+{
+
+    jassert(fallMs >= 0);
+
+    meterFall = fallMs;
+    updateCoefficients();
+
+    meterCalibration = Custom;
+
+}
+
+int HackAudio::Meter::getFallTime() const
+{
+
+    return meterFall;
+
+}
+
+void HackAudio::Meter::setOverThreshold(float threshold, int consecutiveSamples)
+{
+
+    jassert(threshold > 0.0f);
+    jassert(consecutiveSamples > 0);
+
+    overThreshold = threshold;
+    overLength    = consecutiveSamples;
+
+    for (int i = 0; i < meterFeeds.size(); ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            feed->statistics.setThreshold(overThreshold, overLength);
+
+        }
+
+    }
+
+}
+
+float HackAudio::Meter::getOverThreshold() const
+{
+
+    return overThreshold;
+
+}
+
+HackAudio::Meter::Statistics HackAudio::Meter::getStatistics(int channel) const
+{
+
+    Statistics statistics = { 0, 0.0f, 0.0 };
+
+    if (SampleFeed* feed = meterFeeds[channel])
+    {
+
+        statistics.numOvers              = feed->statistics.getNumOvers();
+        statistics.maxLevel              = feed->statistics.getMaxLevel();
+        statistics.secondsAboveThreshold = feed->statistics.getSamplesAboveThreshold() / meterSampleRate;
+
+    }
+
+    return statistics;
+
+}
+
+void HackAudio::Meter::resetStatistics()
+{
+
+    for (int i = 0; i < meterFeeds.size(); ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            feed->statistics.reset();
+
+        }
+
+    }
+
+}
+
+void HackAudio::Meter::setHistoryStatus(bool shouldShowHistory, double seconds)
+{
+
+    jassert(seconds > 0.0);
+
+    historyShown   = shouldShowHistory;
+    historySeconds = seconds;
+
+    if (historyShown && historyBins == nullptr)
+    {
+
+        historyBins.malloc(History::fifoSize);
+
+    }
+
+    for (int i = 0; i < meterChannels.size(); ++i)
+    {
+
+        meterChannels.paintedLevels[i] = -1;
+        meterChannels.paintedPeaks[i]  = -1;
+
+    }
+
+    updateHistory();
+    repaint();
+
+}
+
+bool HackAudio::Meter::getHistoryStatus() const
+{
+
+    return historyShown;
+
+}
+
+double HackAudio::Meter::getHistoryLength() const
+{
+
+    return historySeconds;
 
-    setWantsKeyboardFocus(false);
+}
 
-    pipsShown = true;
+void HackAudio::Meter::ensureChannel(int channel)
+{
 
-    pipSize = 4;
+    jassert(channel >= 0);
 
-    pipLocations.resize(10);
+    if (meterChannels.size() > channel)
+        return;
 
-    meterSkewFactor = 0.0;
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Feeds Changed While The Audio Thread Is Pushing */
+#endif
 
-    meterPeakStatus = false;
-    currentPeakPos = 0.0;
+    meterChannels.setSize(channel + 1);
 
-    meterStyle = Vertical;
+    meterFeeds.ensureStorageAllocated(channel + 1);
 
-    meterRise = 0;
-    meterOvershoot = 0.0f;
-    meterFall = 0;
+    while (meterFeeds.size() <= channel)
+    {
+
+        meterFeeds.add(nullptr);
+
+    }
 
 }
 
-HackAudio::Meter::~Meter()
+void HackAudio::Meter::createFeed(int channel, int fifoSize)
 {
 
+#if JUCE_DEBUG
+    jassert(pushesInProgress == 0);    /* Warning: Feeds Changed While The Audio Thread Is Pushing */
+#endif
+
+    meterChannels.sources[channel] = nullptr;
+    meterChannels.outputs[channel] = 0.0f;
+
+    SampleFeed* feed = meterFeeds.set(channel, new SampleFeed(fifoSize));
+
+    feed->statistics.setThreshold(overThreshold, overLength);
+
+    if (isAnalysisCalibration(meterCalibration))
+    {
+
+        feed->analyser.start(*analysisThread, meterSampleRate);
+
+    }
+
 }
 
-void HackAudio::Meter::setMeterStyle(HackAudio::Meter::MeterStyle style)
+void HackAudio::Meter::updateAnalysis()
 {
 
-    meterStyle = style;
-    resized();
-    repaint();
+    const bool shouldAnalyse = isAnalysisCalibration(meterCalibration);
+
+    for (int i = 0; i < meterFeeds.size(); ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            if (shouldAnalyse)
+            {
+
+                feed->analyser.start(*analysisThread, meterSampleRate);
+
+            }
+            else
+            {
+
+                feed->analyser.stop();
+
+            }
+
+        }
+
+    }
 
 }
 
-HackAudio::Meter::MeterStyle HackAudio::Meter::getMeterStyle() const
+void HackAudio::Meter::updateHistory()
+{
+
+    // The history is one bin per pixel across each channel, so the bins are resized whenever the
+    // channels are and the image starts out empty again
+    const juce::Rectangle<int> lane = getChannelArea(0);
+    const int binsPerLane = (meterStyle == Vertical) ? lane.getWidth() : lane.getHeight();
+
+    if (historyShown && !indicatorArea.isEmpty())
+    {
+
+        historyImage = juce::Image(juce::Image::ARGB, indicatorArea.getWidth(), indicatorArea.getHeight(), true);
+
+    }
+    else
+    {
+
+        historyImage = juce::Image();
+
+    }
+
+    const int samplesPerBin = juce::roundToInt(historySeconds * meterSampleRate / std::max(1, binsPerLane));
+
+    for (int i = 0; i < meterFeeds.size(); ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            feed->history.setSamplesPerBin(samplesPerBin);
+            feed->history.active = historyShown;
+
+        }
+
+    }
+
+}
+
+void HackAudio::Meter::scrollHistory(int channel, const juce::Range<float>* bins, int numBins)
+{
+
+    const juce::Rectangle<int> lane = getChannelArea(channel) - indicatorArea.getPosition();
+
+    if (lane.isEmpty())
+        return;
+
+    // The lane's existing pixels are shifted along in place and only the new bins are drawn,
+    // so the cost of a frame doesn't depend on how much history is shown
+    if (meterStyle == Vertical)
+    {
+
+        const int count = std::min(numBins, lane.getWidth());
+
+        historyImage.moveImageSection(lane.getX(), lane.getY(), lane.getX() + count, lane.getY(), lane.getWidth() - count, lane.getHeight());
+        historyImage.clear(juce::Rectangle<int>(lane.getRight() - count, lane.getY(), count, lane.getHeight()));
+
+        juce::Graphics g(historyImage);
+        g.setColour(findColour(HackAudio::highlightColourId));
+
+        const float centre = lane.getCentreY();
+        const float half   = lane.getHeight() * 0.5f;
+
+        for (int i = 0; i < count; ++i)
+        {
+
+            const juce::Range<float>& bin = bins[numBins - count + i];
+
+            const int top    = juce::roundToInt(centre - juce::jlimit(-1.0f, 1.0f, bin.getEnd()) * half);
+            const int bottom = juce::roundToInt(centre - juce::jlimit(-1.0f, 1.0f, bin.getStart()) * half);
+
+            g.fillRect(lane.getRight() - count + i, top, 1, std::max(1, bottom - top));
+
+        }
+
+    }
+    else
+    {
+
+        const int count = std::min(numBins, lane.getHeight());
+
+        historyImage.moveImageSection(lane.getX(), lane.getY(), lane.getX(), lane.getY() + count, lane.getWidth(), lane.getHeight() - count);
+        historyImage.clear(juce::Rectangle<int>(lane.getX(), lane.getBottom() - count, lane.getWidth(), count));
+
+        juce::Graphics g(historyImage);
+        g.setColour(findColour(HackAudio::highlightColourId));
+
+        const float centre = lane.getCentreX();
+        const float half   = lane.getWidth() * 0.5f;
+
+        for (int i = 0; i < count; ++i)
+        {
+
+            const juce::Range<float>& bin = bins[numBins - count + i];
+
+            const int left  = juce::roundToInt(centre + juce::jlimit(-1.0f, 1.0f, bin.getStart()) * half);
+            const int right = juce::roundToInt(centre + juce::jlimit(-1.0f, 1.0f, bin.getEnd()) * half);
+
+            g.fillRect(left, lane.getBottom() - count + i, std::max(1, right - left), 1);
+
+        }
+
+    }
+
+}
+
+float HackAudio::Meter::getLoudness(bool shortTerm) const
+{
+
+    if (meterCalibration != Momentary && meterCalibration != ShortTerm)
+        return -std::numeric_limits<float>::infinity();
+
+    // Every channel is weighted equally, as for the left, right and centre channels in BS.1770
+    double power = 0.0;
+
+    for (int i = 0; i < meterFeeds.size(); ++i)
+    {
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            power += (shortTerm) ? feed->analyser.getShortTermPower() : feed->analyser.getMomentaryPower();
+
+        }
+
+    }
+
+    if (power <= 0.0)
+        return -std::numeric_limits<float>::infinity();
+
+    return (float)(-0.691 + 10.0 * std::log10(power));
+
+}
+
+void HackAudio::Meter::setPipScale()
+{
+
+    int pipSizeCheck;
+
+    if (meterStyle == Vertical)
+    {
+
+        pipSizeCheck = (indicatorArea.getHeight() - pipSize * 4) / (float)(pipLocations.size() - 1);
+
+    }
+    else
+    {
+
+        pipSizeCheck = (indicatorArea.getWidth() - pipSize * 4) / (float)(pipLocations.size() - 1);
+
+    }
+
+    pipSize = std::min(pipSizeCheck, 4);
+
+}
+
+void HackAudio::Meter::mouseUp(const juce::MouseEvent& e)
+{
+
+    currentPeakPos = 0.0;
+
+    resetStatistics();
+
+}
+
+void HackAudio::Meter::updateCoefficients()
+{
+
+    // These only change with the rise/fall times, so they are cached here rather than
+    // recomputed for every channel on every tick
+    peakAttack  = exp(-1.0f / (float)(ANIMATION_FPS * 0.01f));
+    peakRelease = exp(-1.0f / (float)(ANIMATION_FPS * 1.5f));
+
+    meterRiseCoefficient = (meterRise > 0) ? exp(-1000.0f / (float)(ANIMATION_FPS * meterRise)) : 0.0f;
+    meterFallCoefficient = (meterFall > 0) ? exp(-1000.0f / (float)(ANIMATION_FPS * meterFall)) : 0.0f;
+
+}
+
+void HackAudio::Meter::refresh()
 {
 
-    return meterStyle;
+    if (meterChannels.size() == 0)
+        return;
+
+    const int numChannels = meterChannels.size();
+
+    float* levels  = meterChannels.levels;
+    float* targets = meterChannels.targets;
+    float* outputs = meterChannels.outputs;
+    float* peaks   = meterChannels.peaks;
+
+    const bool analysing = isAnalysisCalibration(meterCalibration);
+
+    const double now = juce::Time::getMillisecondCounterHiRes();
+
+    // Gather each channel's input first. Fed channels use the true peak and averages of every
+    // block pushed since the last tick, polled channels only have the single value they point to.
+    // Fed channels without new data hold their previous input for a moment so the ballistics still
+    // settle on it, then fall silent so the bar releases once the audio callback stops
+    for (int i = 0; i < numChannels; ++i)
+    {
+
+        float level, average, power;
+
+        if (SampleFeed* feed = meterFeeds[i])
+        {
+
+            BlockSummary summary;
+
+            const bool received = feed->pull(summary);
+
+            if (received)
+            {
+
+                feed->lastBlockTime = now;
+
+            }
+
+            const bool stopped = !received && now - feed->lastBlockTime >= meterFeedHoldTime;
+
+            if (analysing)
+            {
+
+                // The analyser runs on its own thread, so its results are read on every tick and
+                // the block summaries are only drained to keep them current
+                if (stopped)
+                {
+
+                    level = 0.0f;
+
+                }
+                else if (meterCalibration == TruePeak)
+                {
+
+                    level = feed->analyser.getTruePeak();
+
+                }
+                else
+                {
+
+                    level = std::sqrt((meterCalibration == Momentary) ? feed->analyser.getMomentaryPower()
+                                                                      : feed->analyser.getShortTermPower());
+
+                }
+
+                levels[i]  = level;
+                targets[i] = level;
+                continue;
+
+            }
+
+            if (received)
+            {
+
+                level   = summary.peak;
+                average = summary.sumOfMagnitudes / (float)summary.numSamples;
+                power   = summary.sumOfSquares / (float)summary.numSamples;
+
+            }
+            else if (stopped)
+            {
+
+                level   = 0.0f;
+                average = 0.0f;
+                power   = 0.0f;
+
+            }
+            else
+            {
+
+                continue;
+
+            }
+
+        }
+        else if (meterChannels.sources[i])
+        {
+
+            float value = *meterChannels.sources[i];
+
+            level   = std::abs(value);
+            average = fmax(0.0f, value);
+            power   = value * value;
+
+        }
+        else
+        {
+
+            level   = 0.0f;
+            average = 0.0f;
+            power   = 0.0f;
+
+        }
+
+        levels[i] = level;
+
+        switch (meterCalibration)
+        {
+            case VU:
+                targets[i] = average;
+                break;
+
+            case RMS:
+                targets[i] = power;
+                break;
+
+            default:
+                targets[i] = level;
+                break;
+        }
+
+    }
+
+    // VU, RMS and loudness meters integrate with the rise time in both directions
+    const float rise = meterRiseCoefficient;
+    const float fall = (meterCalibration == Peak || meterCalibration == Custom || meterCalibration == TruePeak) ? meterFallCoefficient : meterRiseCoefficient;
+
+    const float attack  = peakAttack;
+    const float release = peakRelease;
+
+    // Branch-free smoothing over contiguous channel state so the compiler can vectorize it
+    for (int i = 0; i < numChannels; ++i)
+    {
+
+        const float gp = (peaks[i] < levels[i]) ? attack : release;
+        peaks[i] = clip((1.0f - gp) * levels[i] + gp * peaks[i]);
+
+        const float go = (outputs[i] < targets[i]) ? rise : fall;
+        outputs[i] = clip((1.0f - go) * targets[i] + go * outputs[i]);
+
+    }
+
+    // Only the strip between each channel's previously painted and new extents is invalidated,
+    // along with the old and new peak lines. Channels that moved less than a pixel are skipped
+    const bool vertical = (meterStyle == Vertical);
+    const int  length   = vertical ? indicatorArea.getHeight() : indicatorArea.getWidth();
+
+    juce::RectangleList<int> dirtyAreas;
+
+    if (historyShown && historyImage.isValid())
+    {
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+
+            SampleFeed* feed = meterFeeds[i];
 
-}
+            const int numBins = (feed) ? feed->history.pull(historyBins, History::fifoSize) : 0;
 
-void HackAudio::Meter::setMeterCalibration(HackAudio::Meter::MeterCalibration calibration)
-{
+            if (numBins > 0)
+            {
 
-    switch (calibration)
-    {
-        case Peak:
-            setRiseTime(10);
-            setFallTime(1500);
-            setOvershoot(0);
-            setPeakStatus(false);
-            break;
+                scrollHistory(i, historyBins, numBins);
+                dirtyAreas.add(getChannelArea(i));
 
-        case RMS:
-            setRiseTime(10);
-            setPeakStatus(true);
-            break;
+            }
 
-        case VU:
-            setRiseTime(300);
-            setOvershoot(1.25);
-            setFallTime(300);
-            setPeakStatus(true);
-            break;
+        }
 
-        default:
-            break;
     }
 
-    meterCalibration = calibration;
+    for (int i = 0; i < numChannels; ++i)
+    {
 
-}
+        const int level = (int)(length * outputs[i]);
+        const int peak  = (meterPeakStatus) ? (int)(length * peaks[i]) : -1;
 
-HackAudio::Meter::MeterCalibration HackAudio::Meter::getMeterCalibration() const
-{
+        const int over  = (meterFeeds[i] && meterFeeds[i]->statistics.getNumOvers() > 0) ? 1 : 0;
 
-    return meterCalibration;
+        const int lastLevel = meterChannels.paintedLevels[i];
+        const int lastPeak  = meterChannels.paintedPeaks[i];
+        const int lastOver  = meterChannels.paintedOvers[i];
 
-}
+        if (level == lastLevel && peak == lastPeak && over == lastOver)
+            continue;
 
-void HackAudio::Meter::setSource(int channel, float* const source)
-{
+        meterChannels.paintedLevels[i] = level;
+        meterChannels.paintedPeaks[i]  = peak;
+        meterChannels.paintedOvers[i]  = over;
 
-    meterSources.set(channel, source);
-    meterBuffers.set(channel, 0.0f);
+        const juce::Rectangle<int> channelArea = getChannelArea(i);
 
-    if (!isTimerRunning())
-    {
+        if (lastLevel < 0)
+        {
 
-        startTimerHz(ANIMATION_FPS);
+            dirtyAreas.add(channelArea.expanded(1));
+            continue;
 
-    }
+        }
 
-    repaint();
+        if (level != lastLevel && !(historyShown && meterFeeds[i]))
+        {
 
-}
+            dirtyAreas.add(getChannelStrip(channelArea, std::min(level, lastLevel) - 1, std::max(level, lastLevel) + 1));
 
-void HackAudio::Meter::clearSource(int channel)
-{
+        }
 
-    meterSources.remove(channel);
-    meterBuffers.remove(channel);
+        if (peak != lastPeak)
+        {
 
-    repaint();
+            if (lastPeak >= 0)
+                dirtyAreas.add(getChannelStrip(channelArea, lastPeak - 2, lastPeak + 2));
 
-}
+            if (peak >= 0)
+                dirtyAreas.add(getChannelStrip(channelArea, peak - 2, peak + 2));
 
-void HackAudio::Meter::clearSources()
-{
+        }
 
-    meterSources.clear();
-    meterBuffers.clear();
+        if (over != lastOver)
+        {
 
-    stopTimer();
-    
-}
+            dirtyAreas.add(getChannelStrip(channelArea, length - meterOverSize, length));
 
-void HackAudio::Meter::setSkewFactor(double factor, bool symmetricSkew)
-{
+        }
 
-    meterSkewFactor = factor;
+    }
 
-}
+    dirtyAreas.clipTo(indicatorArea);
+    dirtyAreas.consolidate();
 
-void HackAudio::Meter::setSkewFactorFromMidPoint(double meterValueToShowAtMidPoint)
-{
+    repaintChannels(dirtyAreas);
 
 }
 
-double HackAudio::Meter::getSkewFactor() const
+void HackAudio::Meter::repaintChannels(const juce::RectangleList<int>& dirtyAreas)
 {
 
-    return meterSkewFactor;
-
-}
+    for (int i = 0; i < dirtyAreas.getNumRectangles(); ++i)
+    {
 
-void HackAudio::Meter::setPipState(bool shouldBeShown)
-{
+        repaint(dirtyAreas.getRectangle(i));
 
-    pipsShown = shouldBeShown;
-    resized();
-    repaint();
+    }
 
 }
 
-bool HackAudio::Meter::getPipState() const
+juce::Rectangle<int> HackAudio::Meter::getChannelArea(int channel) const
 {
 
-    return pipsShown;
+    const int numChannels = std::max(1, meterChannels.size());
 
-}
+    if (meterStyle == Vertical)
+    {
 
-void HackAudio::Meter::setPipCount(int count)
-{
+        const int channelWidth = indicatorArea.getWidth() / numChannels;
 
-    pipLocations.resize(count);
-    resized();
-    repaint();
+        return juce::Rectangle<int>(
+            indicatorArea.getX() + channelWidth * channel,
+            indicatorArea.getY(),
+            channelWidth,
+            indicatorArea.getHeight()
+        );
 
-}
+    }
+    else
+    {
 
-int HackAudio::Meter::getPipCount() const
-{
+        const int channelHeight = indicatorArea.getHeight() / numChannels;
 
-    return pipLocations.size();
+        return juce::Rectangle<int>(
+            indicatorArea.getX(),
+            indicatorArea.getY() + channelHeight * channel,
+            indicatorArea.getWidth(),
+            channelHeight
+        );
+
+    }
 
 }
 
-void HackAudio::Meter::setPeakStatus(bool shouldShowPeak)
+juce::Rectangle<int> HackAudio::Meter::getChannelStrip(juce::Rectangle<int> channelArea, int start, int end) const
 {
 
-    meterPeakStatus = shouldShowPeak;
+    // Strips are widened by a pixel across the channel to cover its separator line
+    if (meterStyle == Vertical)
+    {
 
-}
+        return juce::Rectangle<int>(
+            channelArea.getX() - 1,
+            channelArea.getBottom() - end,
+            channelArea.getWidth() + 2,
+            end - start
+        );
 
-bool HackAudio::Meter::getPeakStatus() const
-{
+    }
+    else
+    {
 
-    return meterPeakStatus;
+        return juce::Rectangle<int>(
+            channelArea.getX() + start,
+            channelArea.getY() - 1,
+            end - start,
+            channelArea.getHeight() + 2
+        );
+
+    }
 
 }
 
-void HackAudio::Meter::setRiseTime(int riseMs)
+void HackAudio::Meter::renderChrome(float scale)
 {
 
-    jassert(riseMs >= 0);
+    int width  = getWidth();
+    int height = getHeight();
 
-    meterRise = riseMs;
+    chromeScale = scale;
 
-    meterCalibration = Custom;
+    const int imageWidth  = juce::roundToInt(width * scale);
+    const int imageHeight = juce::roundToInt(height * scale);
 
-}
+    if (imageWidth <= 0 || imageHeight <= 0)
+    {
 
-int HackAudio::Meter::getRiseTime() const
-{
+        chromeBackground = juce::Image();
+        chromeForeground = juce::Image();
+        return;
 
-    return meterRise;
+    }
 
-}
+    chromeBackground = juce::Image(juce::Image::ARGB, imageWidth, imageHeight, true);
+    chromeForeground = juce::Image(juce::Image::ARGB, imageWidth, imageHeight, true);
 
-void HackAudio::Meter::setOvershoot(float overshoot)
-{
+    {
 
-    jassert(overshoot >= 0.0f);
+        juce::Graphics g(chromeBackground);
+        g.addTransform(juce::AffineTransform::scale(scale));
 
-    meterOvershoot = overshoot;
+        juce::Path b;
+        b.addRoundedRectangle(0, 0, width, height, CORNER_CONFIG);
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        g.fillPath(b);
 
-    meterCalibration = Custom;
+        g.setColour(findColour(HackAudio::backgroundColourId));
+        g.fillRect(indicatorArea);
 
-}
+    }
 
-float HackAudio::Meter::getOvershoot() const
-{
+    {
 
-    return meterOvershoot;
+        juce::Graphics g(chromeForeground);
+        g.addTransform(juce::AffineTransform::scale(scale));
 
-}
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        for (int i = 0; i < pipLocations.size(); ++i)
+        {
 
-void HackAudio::Meter::setFallTime(int fallMs)
-{
+            juce::Point<int>& pip = pipLocations.getReference(i);
+            g.fillEllipse(pip.x - pipSize/2, pip.y - pipSize/2, pipSize, pipSize);
 
-    jassert(fallMs >= 0);
+        }
 
-    meterFall = fallMs;
+        juce::Path p;
+        p.addRoundedRectangle(4, 4, width - 8, height - 8, CORNER_CONFIG);
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        g.strokePath(p, juce::PathStrokeType(8));
 
-    meterCalibration = Custom;
+    }
 
 }
 
-int HackAudio::Meter::getFallTime() const
+void HackAudio::Meter::colourChanged()
 {
 
-    return meterFall;
+    chromeBackground = juce::Image();
+    chromeForeground = juce::Image();
+
+    repaint();
 
 }
 
-void HackAudio::Meter::setPipScale()
+int HackAudio::Meter::getNumChannels() const
 {
 
-    int pipSizeCheck;
+    return meterChannels.size();
 
-    if (meterStyle == Vertical)
-    {
+}
 
-        pipSizeCheck = (indicatorArea.getHeight() - pipSize * 4) / (float)(pipLocations.size() - 1);
+float HackAudio::Meter::getChannelLevel(int channel) const
+{
 
-    }
-    else
-    {
+    return meterChannels.outputs[channel];
 
-        pipSizeCheck = (indicatorArea.getWidth() - pipSize * 4) / (float)(pipLocations.size() - 1);
+}
 
-    }
+float HackAudio::Meter::getChannelPeak(int channel) const
+{
 
-    pipSize = std::min(pipSizeCheck, 4);
+    return meterChannels.peaks[channel];
 
 }
 
-void HackAudio::Meter::mouseUp(const juce::MouseEvent& e)
+bool HackAudio::Meter::isChannelOver(int channel) const
 {
 
-    currentPeakPos = 0.0;
+    return meterChannels.paintedOvers[channel] > 0;
 
 }
 
-void HackAudio::Meter::timerCallback()
+bool HackAudio::Meter::isChannelFed(int channel) const
 {
 
-    if (meterSources.size() == 0)
-    {
-
-        stopTimer();
+    return meterFeeds[channel] != nullptr;
 
-    }
+}
 
-    float rise = (float)meterRise / 1000.0f;
-    float fall = (float)meterFall / 1000.0f;
+juce::Rectangle<int> HackAudio::Meter::getIndicatorArea() const
+{
 
-    for (int i = 0; i < meterSources.size(); ++i)
-    {
+    return indicatorArea;
 
-        float in   = std::abs(*meterSources[i]);
-        float last = meterBuffers[i];
-        float peak = meterPeaks[i];
-        float out;
+}
 
-        float ga = exp(-1.0f / (float)(ANIMATION_FPS * 0.01f));
-        float gr = exp(-1.0f / (float)(ANIMATION_FPS * 1.5f));
+void HackAudio::Meter::paintChromeBackground(juce::Graphics& g)
+{
 
-        float g;
+    // The background, pips and outline only change with the size and colours, so they are
+    // rendered once into images and blitted underneath and on top of the channels
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-        if (peak < in)
-        {
-            g = ga;
-        }
-        else
-        {
-            g = gr;
-        }
+    if (!chromeBackground.isValid() || scale != chromeScale)
+    {
 
-        peak = (1.0f - g) * in + g * peak;
-        meterPeaks.set(i, clip(peak));
+        renderChrome(scale);
 
-        if (meterCalibration == Peak || meterCalibration == Custom)
-        {
+    }
 
-            in   = std::abs(*meterSources[i]);
-            last = meterBuffers[i];
+    if (chromeBackground.isValid())
+    {
 
-            ga = exp(-1.0f / (float)(ANIMATION_FPS * rise));
-            gr = exp(-1.0f / (float)(ANIMATION_FPS * fall));
+        g.drawImageTransformed(chromeBackground, juce::AffineTransform::scale(1.0f / chromeScale));
 
-            if (last < in)
-            {
-                g = ga;
-            }
-            else
-            {
-                g = gr;
-            }
+    }
 
-            out = (1.0f - g) * in + g * last;
+}
 
-        }
-        else if (meterCalibration == VU)
-        {
+void HackAudio::Meter::paintChromeForeground(juce::Graphics& g)
+{
 
-            in   = fmax(0.0f, *meterSources[i]);
-            last = meterBuffers[i];
-            g = exp(-1.0f / (float)(ANIMATION_FPS * rise));
+    if (chromeForeground.isValid())
+    {
 
-            out = (1.0f - g) * in + g * last;
+        g.drawImageTransformed(chromeForeground, juce::AffineTransform::scale(1.0f / chromeScale));
 
-        }
-        else /*if (meterCalibration == RMS)*/
-        {
+    }
 
-            in   = (*meterSources[i]) * (*meterSources[i]);
-            last = meterBuffers[i];
-            g = exp(-1.0f / (float)(ANIMATION_FPS * rise));
+}
 
-            out = (1.0f - g) * in + g * last;
+void HackAudio::Meter::paintHistory(juce::Graphics& g)
+{
 
-        }
+    if (historyShown && historyImage.isValid())
+    {
 
-        meterBuffers.set(i, clip(out));
-        repaint(indicatorArea);
+        g.drawImageAt(historyImage, indicatorArea.getX(), indicatorArea.getY());
 
     }
 
@@ -390,40 +2208,43 @@ void HackAudio::Meter::timerCallback()
 void HackAudio::Meter::paint(juce::Graphics& g)
 {
 
-    int width  = getWidth();
-    int height = getHeight();
+    paintChromeBackground(g);
+    paintHistory(g);
 
-    juce::Path b;
-    b.addRoundedRectangle(0, 0, width, height, CORNER_CONFIG);
-    g.setColour(findColour(HackAudio::midgroundColourId));
-    g.fillPath(b);
+    const juce::Rectangle<int> clipBounds = g.getClipBounds();
 
-    g.setColour(findColour(HackAudio::backgroundColourId));
-    g.fillRect(indicatorArea);
-
-    if (meterSources.size())
+    if (meterChannels.size())
     {
 
         if (meterStyle == Vertical)
         {
 
-            int channelWidth = indicatorArea.getWidth() / meterSources.size();
+            int channelWidth = indicatorArea.getWidth() / meterChannels.size();
 
-            for (int channel = 0; channel < meterSources.size(); ++channel)
+            for (int channel = 0; channel < meterChannels.size(); ++channel)
             {
 
-                float output = meterBuffers[channel];
-                float peak   = meterPeaks[channel];
+                if (!clipBounds.intersects(getChannelArea(channel).expanded(1)))
+                    continue;
 
-                g.setColour(findColour(HackAudio::highlightColourId));
+                float output = meterChannels.outputs[channel];
+                float peak   = meterChannels.peaks[channel];
 
-                g.fillRect
-                (
-                   indicatorArea.getX() + channelWidth * channel,
-                   indicatorArea.getBottom() - (int)(indicatorArea.getHeight() * output),
-                   channelWidth,
-                   (int)(indicatorArea.getHeight() * output)
-                );
+                // Fed channels showing their history have no bar
+                if (!historyShown || !meterFeeds[channel])
+                {
+
+                    g.setColour(findColour(HackAudio::highlightColourId));
+
+                    g.fillRect
+                    (
+                       indicatorArea.getX() + channelWidth * channel,
+                       indicatorArea.getBottom() - (int)(indicatorArea.getHeight() * output),
+                       channelWidth,
+                       (int)(indicatorArea.getHeight() * output)
+                    );
+
+                }
 
                 if (meterPeakStatus)
                 {
@@ -441,6 +2262,21 @@ void HackAudio::Meter::paint(juce::Graphics& g)
                     
                 }
 
+                if (meterChannels.paintedOvers[channel] > 0)
+                {
+
+                    g.setColour(findColour(HackAudio::foregroundColourId));
+
+                    g.fillRect
+                    (
+                        indicatorArea.getX() + channelWidth * channel,
+                        indicatorArea.getY(),
+                        channelWidth,
+                        meterOverSize
+                    );
+
+                }
+
                 g.setColour(findColour(HackAudio::backgroundColourId));
                 g.drawLine
                 (
@@ -457,23 +2293,31 @@ void HackAudio::Meter::paint(juce::Graphics& g)
         else if (meterStyle == Horizontal)
         {
 
-            int channelHeight = indicatorArea.getHeight() / meterSources.size();
+            int channelHeight = indicatorArea.getHeight() / meterChannels.size();
 
-            for (int channel = 0; channel < meterSources.size(); ++channel)
+            for (int channel = 0; channel < meterChannels.size(); ++channel)
             {
 
-                float output = meterBuffers[channel];
-                float peak   = meterPeaks[channel];
+                if (!clipBounds.intersects(getChannelArea(channel).expanded(1)))
+                    continue;
 
-                g.setColour(findColour(HackAudio::highlightColourId));
+                float output = meterChannels.outputs[channel];
+                float peak   = meterChannels.peaks[channel];
 
-                g.fillRect
-                (
-                    indicatorArea.getX(),
-                    indicatorArea.getY() + channelHeight * channel,
-                    (int)(indicatorArea.getWidth() * output),
-                    channelHeight
-                );
+                if (!historyShown || !meterFeeds[channel])
+                {
+
+                    g.setColour(findColour(HackAudio::highlightColourId));
+
+                    g.fillRect
+                    (
+                        indicatorArea.getX(),
+                        indicatorArea.getY() + channelHeight * channel,
+                        (int)(indicatorArea.getWidth() * output),
+                        channelHeight
+                    );
+
+                }
 
                 if (meterPeakStatus)
                 {
@@ -491,6 +2335,21 @@ void HackAudio::Meter::paint(juce::Graphics& g)
 
                 }
 
+                if (meterChannels.paintedOvers[channel] > 0)
+                {
+
+                    g.setColour(findColour(HackAudio::foregroundColourId));
+
+                    g.fillRect
+                    (
+                        indicatorArea.getRight() - meterOverSize,
+                        indicatorArea.getY() + channelHeight * channel,
+                        meterOverSize,
+                        channelHeight
+                    );
+
+                }
+
                 g.setColour(findColour(HackAudio::backgroundColourId));
                 g.drawLine
                 (
@@ -507,19 +2366,7 @@ void HackAudio::Meter::paint(juce::Graphics& g)
 
     }
 
-    g.setColour(findColour(HackAudio::midgroundColourId));
-    for (int i = 0; i < pipLocations.size(); ++i)
-    {
-
-        juce::Point<int>& pip = pipLocations.getReference(i);
-        g.fillEllipse(pip.x - pipSize/2, pip.y - pipSize/2, pipSize, pipSize);
-
-    }
-
-    juce::Path p;
-    p.addRoundedRectangle(4, 4, width - 8, height - 8, CORNER_CONFIG);
-    g.setColour(findColour(HackAudio::midgroundColourId));
-    g.strokePath(p, juce::PathStrokeType(8));
+    paintChromeForeground(g);
 
 }
 
@@ -531,6 +2378,19 @@ void HackAudio::Meter::resized()
 
     indicatorArea.setBounds(8, 8, width - 16, height - 16);
 
+    for (int i = 0; i < meterChannels.size(); ++i)
+    {
+
+        meterChannels.paintedLevels[i] = -1;
+        meterChannels.paintedPeaks[i]  = -1;
+
+    }
+
+    chromeBackground = juce::Image();
+    chromeForeground = juce::Image();
+
+    updateHistory();
+
     for (int i = 0; i < pipLocations.size(); ++i)
     {
 
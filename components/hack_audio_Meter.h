@@ -30,9 +30,13 @@ namespace HackAudio
 /**
  A custom meter component used to measure audio signals 
 */
-class Meter : public juce::Component,
-              private juce::Timer
+class Meter : public juce::Component
 {
+
+    #if HACK_AUDIO_ENABLE_BENCHMARKS
+    friend class Benchmark;
+    #endif
+
 public:
 
     /**
@@ -55,6 +59,21 @@ public:
         RMS,            /**< Root-Mean-Square (RMS), a display of the overall average level of the incoming signal */
         VU,             /**< Volume-Units (VU), based on specifications of analog VU meters where 0VU = +4 dBu */
         Custom,         /**< Custom is automatically assigned whenever meter attributes are manually set */
+        TruePeak,       /**< True-peak (ITU-R BS.1770), the inter-sample peak of the 4x oversampled signal. Requires channels fed with setSampleSource */
+        Momentary,      /**< Momentary loudness (ITU-R BS.1770), the K-weighted level over a 400ms window. Requires channels fed with setSampleSource */
+        ShortTerm       /**< Short-term loudness (ITU-R BS.1770), the K-weighted level over a 3s window. Requires channels fed with setSampleSource */
+    };
+
+    /**
+     The over and peak-hold statistics of a fed channel since they were last reset
+
+     @see getStatistics
+    */
+    struct Statistics
+    {
+        int    numOvers;                /**< The number of runs of consecutive samples at or above the over threshold */
+        float  maxLevel;                /**< The largest absolute sample value */
+        double secondsAboveThreshold;   /**< The total time spent at or above the over threshold */
     };
 
     Meter();
@@ -81,19 +100,96 @@ public:
     MeterCalibration getMeterCalibration() const;
 
     /**
-     Sets the float value to listen for
+     Sets the float value to listen for. This replaces any feed set up with setSampleSource, and
+     adding a new channel can reallocate the feed table, so the audio thread must not be pushing
+     samples to this meter while it's called
      
      @param source  a value ranging from 0.0 to 1.0
     */
     void setSource(int channel, float* const source);
 
+    /**
+     Prepares a channel to be fed whole blocks of samples with pushSamples instead of polling
+     a single float. This allocates the channel's FIFO and deletes any previous one, so it must
+     be called on the message thread while the audio thread isn't pushing samples to this meter
+
+     @param channel     the meter channel to feed
+     @param fifoSize    the number of pushed blocks that can be queued between meter refreshes
+    */
+    void setSampleSource(int channel, int fifoSize = 512);
+
+    /**
+     Pushes a block of samples to a channel previously prepared with setSampleSource. This is
+     wait-free and never allocates, so it is safe to call from the audio callback
+    */
+    void pushSamples(int channel, const float* samples, int numSamples);
+
+    /**
+     Prepares the first numChannels channels to be fed with pushSamples in one call, e.g. for
+     every channel of a multichannel interface. Like setSampleSource this allocates, so it must
+     be called on the message thread while the audio thread isn't pushing samples to this meter
+
+     @param numChannels the number of meter channels to feed, starting from channel 0
+     @param fifoSize    the number of pushed blocks that can be queued between meter refreshes
+    */
+    void setSampleSources(int numChannels, int fifoSize = 512);
+
+    /**
+     Pushes a block of planar samples, one pointer per channel, to channels previously prepared
+     with setSampleSource or setSampleSources. This is wait-free and never allocates
+
+     @param channelData an array of numChannels channel pointers, e.g. from AudioBuffer::getArrayOfReadPointers
+    */
+    void pushSamples(const float* const* channelData, int numChannels, int numSamples);
+
+    /**
+     Pushes every channel of an AudioBuffer to the meter's matching channels
+    */
+    void pushSamples(const juce::AudioBuffer<float>& buffer);
+
+    /**
+     Pushes a block of interleaved samples to channels previously prepared with setSampleSource
+     or setSampleSources. This is wait-free and never allocates
+
+     @param samples     numSamples frames of numChannels interleaved samples
+    */
+    void pushInterleavedSamples(const float* samples, int numChannels, int numSamples);
+
+    /**
+     Sets the sample rate of the audio pushed with pushSamples, used by the TruePeak, Momentary
+     and ShortTerm calibrations. This defaults to 44100
+    */
+    void setSampleRate(double sampleRate);
+
+    /**
+     Returns the sample rate the meter's analysis expects
+    */
+    double getSampleRate() const;
+
+    /**
+     Returns the momentary loudness in LUFS of all fed channels, or negative infinity if the
+     meter isn't using the Momentary or ShortTerm calibration
+    */
+    float getMomentaryLoudness() const;
+
+    /**
+     Returns the short-term loudness in LUFS of all fed channels, or negative infinity if the
+     meter isn't using the Momentary or ShortTerm calibration
+    */
+    float getShortTermLoudness() const;
+
     /**
      Stops the meter from listening to a source
+
+     The channel keeps its place so later channels aren't renumbered, although cleared channels
+     at the end of the meter are dropped. This deletes the channel's feed, so the audio thread
+     must have stopped pushing samples to this meter first, as it must before the meter is deleted
     */
     void clearSource(int channel);
 
     /**
-     Stops the meter from listening to all sources
+     Stops the meter from listening to all sources. Like clearSource, this must only be called
+     once the audio thread has stopped pushing samples to this meter
     */
     void clearSources();
 
@@ -174,13 +270,402 @@ public:
     */
     int getFallTime() const;
 
+    /**
+     Sets the level that counts as an over for the statistics of fed channels. An over is
+     counted once for each run of at least consecutiveSamples samples at or above the threshold
+
+     @param threshold           an absolute sample value, 1.0 (0dBFS) by default
+     @param consecutiveSamples  the run length that counts as an over, 1 by default
+    */
+    void setOverThreshold(float threshold, int consecutiveSamples = 1);
+
+    /**
+     Returns the level that counts as an over
+    */
+    float getOverThreshold() const;
+
+    /**
+     Returns the statistics of a channel fed with setSampleSource. These are computed on the
+     audio thread and only read from atomics here, so this can be called from any thread as long
+     as the meter's channels aren't being set up at the same time
+    */
+    Statistics getStatistics(int channel) const;
+
+    /**
+     Resets the statistics of every channel. Clicking the meter does the same
+    */
+    void resetStatistics();
+
+    /**
+     Shows a scrolling min/max history of each fed channel's waveform in place of its bar. Only
+     channels fed with setSampleSource keep a history
+
+     @param shouldShowHistory   whether the history should replace the meter's bars
+     @param seconds             the length of history that fits across each channel
+    */
+    void setHistoryStatus(bool shouldShowHistory, double seconds = 5.0);
+
+    /**
+     Returns the current status for displaying the level history
+    */
+    bool getHistoryStatus() const;
+
+    /**
+     Returns the length in seconds of the displayed level history
+    */
+    double getHistoryLength() const;
+
+protected:
+
+    /**
+     Returns the number of channels the meter is showing
+    */
+    int getNumChannels() const;
+
+    /**
+     Returns the smoothed level a channel's bar is showing, from 0.0 to 1.0
+    */
+    float getChannelLevel(int channel) const;
+
+    /**
+     Returns the position of a channel's peak line, from 0.0 to 1.0
+    */
+    float getChannelPeak(int channel) const;
+
+    /**
+     Returns true while a channel's over indicator is lit
+    */
+    bool isChannelOver(int channel) const;
+
+    /**
+     Returns true if a channel is fed with setSampleSource rather than a float value
+    */
+    bool isChannelFed(int channel) const;
+
+    /**
+     Returns the area the channels are drawn in
+    */
+    juce::Rectangle<int> getIndicatorArea() const;
+
+    /**
+     Draws the cached background and pips that sit underneath the channels
+    */
+    void paintChromeBackground(juce::Graphics& g);
+
+    /**
+     Draws the cached outline that sits on top of the channels
+    */
+    void paintChromeForeground(juce::Graphics& g);
+
+    /**
+     Draws the level history of the fed channels when it's shown
+    */
+    void paintHistory(juce::Graphics& g);
+
+    /**
+     Called by each refresh with the areas of the channels that changed since the last one
+    */
+    virtual void repaintChannels(const juce::RectangleList<int>& dirtyAreas);
+
 private:
 
+    /**
+     The level summary of one or more blocks of samples pushed to a channel
+    */
+    struct BlockSummary
+    {
+
+        BlockSummary();
+
+        void add(const float* samples, int numSamples);
+        void merge(const BlockSummary& other);
+        void reset();
+
+        float peak;
+        float sumOfMagnitudes;
+        float sumOfSquares;
+        int   numSamples;
+
+    };
+
+    /**
+     The background thread shared by every meter's channel analysers
+    */
+    class AnalysisThread : public juce::TimeSliceThread
+    {
+
+    public:
+
+        AnalysisThread();
+        ~AnalysisThread();
+
+    };
+
+    /**
+     Computes the true-peak and K-weighted loudness of one channel's sample stream on the
+     AnalysisThread, so neither the audio nor the message thread pays for the oversampling
+     and filtering
+    */
+    class Analyser : public juce::TimeSliceClient
+    {
+
+    public:
+
+        Analyser();
+        ~Analyser();
+
+        void start(AnalysisThread& thread, double sampleRate);
+        void stop();
+
+        void push(const float* samples, int numSamples);
+
+        float getTruePeak();
+        float getMomentaryPower() const;
+        float getShortTermPower() const;
+
+    private:
+
+        enum
+        {
+            fifoSize      = 16384,
+            maxBlockSize  = 512,
+            numPhases     = 4,
+            numTaps       = 12,
+            numSubBlocks  = 30
+        };
+
+        int useTimeSlice() override;
+
+        void process(const float* samples, int numSamples);
+
+        juce::AbstractFifo fifo;
+        juce::HeapBlock<float> fifoSamples;
+
+        juce::HeapBlock<float> history;
+        juce::HeapBlock<float> oversampled;
+
+        double shelfB[3], shelfA[3], shelfState[2];
+        double highpassB[3], highpassA[3], highpassState[2];
+
+        double subBlockEnergy;
+        int    subBlockLength, subBlockCount;
+        int    subBlockIndex;
+        double subBlockEnergies[numSubBlocks];
+
+        std::atomic<bool>  active;
+        std::atomic<float> truePeak;
+        std::atomic<float> momentaryPower;
+        std::atomic<float> shortTermPower;
+
+        AnalysisThread* analysisThread;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Analyser)
+
+    };
+
+    /**
+     The per-channel display state of every meter channel, kept as a struct-of-arrays in one
+     contiguous allocation that grows geometrically
+    */
+    class ChannelState
+    {
+
+    public:
+
+        ChannelState();
+
+        int  size() const;
+
+        void setSize(int numChannels);
+        void reset(int channel);
+        void clear();
+
+        float** sources;
+        float*  outputs;
+        float*  peaks;
+        float*  levels;
+        float*  targets;
+        int*    paintedLevels;
+        int*    paintedPeaks;
+        int*    paintedOvers;
+
+    private:
+
+        void allocate(int newCapacity);
+
+        juce::HeapBlock<char> block;
+
+        int numChannels;
+        int capacity;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelState)
+
+    };
+
+    /**
+     Decimates one channel's samples into min/max bins on the audio thread, queued in a fixed-size
+     ring for the meter to scroll into its history image
+    */
+    class History
+    {
+
+    public:
+
+        enum
+        {
+            fifoSize = 4096
+        };
+
+        History();
+
+        void setSamplesPerBin(int samplesPerBin);
+
+        void push(const float* samples, int numSamples);
+        int  pull(juce::Range<float>* destination, int maxBins);
+
+        std::atomic<bool> active;
+
+    private:
+
+        juce::AbstractFifo fifo;
+        juce::HeapBlock<juce::Range<float>> bins;
+
+        std::atomic<int> binLength;
+
+        float binMin, binMax;
+        int   binCount;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (History)
+
+    };
+
+    /**
+     Counts overs and tracks the maximum level of one channel sample by sample on the audio
+     thread. The message thread may reset the counters at any time
+    */
+    class StatisticsCounter
+    {
+
+    public:
+
+        StatisticsCounter();
+
+        void setThreshold(float threshold, int consecutiveSamples);
+
+        void push(const float* samples, int numSamples);
+        void reset();
+
+        int         getNumOvers() const;
+        float       getMaxLevel() const;
+        juce::int64 getSamplesAboveThreshold() const;
+
+    private:
+
+        std::atomic<float> overThreshold;
+        std::atomic<int>   overLength;
+
+        std::atomic<int>         numOvers;
+        std::atomic<float>       maxLevel;
+        std::atomic<juce::int64> samplesAboveThreshold;
+
+        int runLength;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StatisticsCounter)
+
+    };
+
+    /**
+     A single-producer single-consumer queue of block summaries for one meter channel
+    */
+    class SampleFeed
+    {
+
+    public:
+
+        SampleFeed(int fifoSize);
+
+        void push(const float* samples, int numSamples);
+        bool pull(BlockSummary& result);
+
+        Analyser          analyser;
+        History           history;
+        StatisticsCounter statistics;
+
+        double lastBlockTime;   /**< When a block was last pulled, in milliseconds, only touched on the message thread */
+
+    private:
+
+        juce::AbstractFifo fifo;
+        juce::HeapBlock<BlockSummary> summaries;
+
+        BlockSummary pending;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleFeed)
+
+    };
+
+    /**
+     Refreshes every registered meter from a single timer (or the display's vertical blank where
+     JUCE supports it) rather than giving each meter its own juce::Timer
+    */
+    class Scheduler : private juce::Timer
+    {
+
+    public:
+
+        Scheduler();
+        ~Scheduler();
+
+        void add(Meter* meter);
+        void remove(Meter* meter);
+
+    private:
+
+        void tick();
+
+        void timerCallback() override;
+
+        juce::Array<Meter*> meters;
+
+        double lastTick;
+
+        #if JUCE_MAJOR_VERSION >= 7
+        void attachToDisplay();
+
+        std::unique_ptr<juce::VBlankAttachment> vblank;
+        Meter* vblankMeter;
+        #endif
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Scheduler)
+
+    };
+
+    void ensureChannel(int channel);
+
+    void createFeed(int channel, int fifoSize);
+
+    void updateCoefficients();
+
+    void updateAnalysis();
+
+    void updateHistory();
+
+    void scrollHistory(int channel, const juce::Range<float>* bins, int numBins);
+
+    float getLoudness(bool shortTerm) const;
+
     void setPipScale();
 
     void mouseUp(const juce::MouseEvent& e) override;
 
-    void timerCallback() override;
+    void refresh();
+
+    juce::Rectangle<int> getChannelArea(int channel) const;
+    juce::Rectangle<int> getChannelStrip(juce::Rectangle<int> channelArea, int start, int end) const;
+
+    void renderChrome(float scale);
+
+    void colourChanged() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
@@ -192,6 +677,10 @@ private:
 
     juce::Rectangle<int> indicatorArea;
 
+    juce::Image chromeBackground;
+    juce::Image chromeForeground;
+    float       chromeScale;
+
     bool meterPeakStatus;
     double currentPeakPos;
 
@@ -199,9 +688,31 @@ private:
     float meterOvershoot;
     int   meterFall;
 
-    juce::Array<float*> meterSources;
-    juce::Array<float>  meterBuffers;
-    juce::Array<float>  meterPeaks;
+    float peakAttack, peakRelease;
+    float meterRiseCoefficient, meterFallCoefficient;
+
+    ChannelState meterChannels;
+
+    double meterSampleRate;
+
+    juce::SharedResourcePointer<AnalysisThread> analysisThread;
+
+    juce::OwnedArray<SampleFeed> meterFeeds;
+
+#if JUCE_DEBUG
+    std::atomic<int> pushesInProgress;  /**< Lets the feeds being changed while the audio thread is pushing to them be caught */
+#endif
+
+    float overThreshold;
+    int   overLength;
+
+    bool   historyShown;
+    double historySeconds;
+
+    juce::Image historyImage;
+    juce::HeapBlock<juce::Range<float>> historyBins;
+
+    juce::SharedResourcePointer<Scheduler> scheduler;
 
     MeterStyle       meterStyle;
     MeterCalibration meterCalibration;
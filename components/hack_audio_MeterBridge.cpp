@@ -0,0 +1,227 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+inline void fillBridgePixels(juce::uint32* destination, juce::uint32 pixel, int count)
+{
+
+    // A plain loop over whole 32-bit pixels, which the compiler turns into wide vector stores
+    for (int i = 0; i < count; ++i)
+    {
+
+        destination[i] = pixel;
+
+    }
+
+}
+
+inline void fillBridgeRect(juce::Image::BitmapData& pixels, juce::Rectangle<int> area, juce::Rectangle<int> rect, juce::uint32 pixel)
+{
+
+    rect = rect.getIntersection(area);
+
+    for (int y = rect.getY(); y < rect.getBottom(); ++y)
+    {
+
+        fillBridgePixels(reinterpret_cast<juce::uint32*>(pixels.getPixelPointer(rect.getX(), y)), pixel, rect.getWidth());
+
+    }
+
+}
+
+HackAudio::MeterBridge::MeterBridge()
+{
+
+    bridgeScale = 1.0f;
+
+}
+
+HackAudio::MeterBridge::~MeterBridge()
+{
+
+}
+
+void HackAudio::MeterBridge::repaintChannels(const juce::RectangleList<int>& dirtyAreas)
+{
+
+    if (!dirtyAreas.isEmpty())
+    {
+
+        repaint(dirtyAreas.getBounds());
+
+    }
+
+}
+
+void HackAudio::MeterBridge::renderChannels(juce::Rectangle<int> area)
+{
+
+    area = area.getIntersection(bridgeImage.getBounds());
+
+    if (area.isEmpty())
+        return;
+
+    const juce::uint32 background = findColour(HackAudio::backgroundColourId).getPixelARGB().getNativeARGB();
+    const juce::uint32 foreground = findColour(HackAudio::foregroundColourId).getPixelARGB().getNativeARGB();
+    const juce::uint32 highlight  = findColour(HackAudio::highlightColourId).getPixelARGB().getNativeARGB();
+
+    juce::Image::BitmapData pixels(bridgeImage, juce::Image::BitmapData::writeOnly);
+
+    const juce::Rectangle<int> indicatorArea = getIndicatorArea();
+
+    const int  numChannels  = getNumChannels();
+    const bool vertical     = (getMeterStyle() == Vertical);
+    const bool peakShown    = getPeakStatus();
+    const bool historyShown = getHistoryStatus();
+
+    const int width  = bridgeImage.getWidth();
+    const int height = bridgeImage.getHeight();
+    const int length = (vertical) ? height : width;
+
+    // Channels keep the regular meter's integer size, measured here in the image's physical pixels
+    const float channelSize = (numChannels > 0) ? ((vertical) ? indicatorArea.getWidth() : indicatorArea.getHeight()) / numChannels * bridgeScale : 0.0f;
+
+    if (channelSize <= 0.0f)
+    {
+
+        fillBridgeRect(pixels, area, area, background);
+        return;
+
+    }
+
+    const int peakSize = std::max(1, juce::roundToInt(2.0f * bridgeScale));
+    const int overSize = std::max(1, juce::roundToInt(meterOverSize * bridgeScale));
+
+    const int areaStart = (vertical) ? area.getX() : area.getY();
+    const int areaEnd   = (vertical) ? area.getRight() : area.getBottom();
+
+    const int firstChannel = std::max(0, (int)(areaStart / channelSize));
+    const int lastChannel  = std::min(numChannels - 1, (int)(areaEnd / channelSize));
+
+    for (int channel = firstChannel; channel <= lastChannel; ++channel)
+    {
+
+        const int start = juce::roundToInt(channel * channelSize);
+        const int end   = juce::roundToInt((channel + 1) * channelSize);
+
+        // Fed channels showing their history have no bar, the history image is drawn over them
+        const bool  barShown = !historyShown || !isChannelFed(channel);
+        const int   level    = (barShown) ? (int)(length * getChannelLevel(channel)) : 0;
+        const int   peak     = (int)(length * getChannelPeak(channel));
+
+        juce::Rectangle<int> strip = (vertical) ? juce::Rectangle<int>(start, 0, end - start, height)
+                                                : juce::Rectangle<int>(0, start, width, end - start);
+
+        // The lit and unlit parts partition the strip, so each pixel is only written once
+        // apart from the thin peak, over and separator lines
+        const juce::Rectangle<int> bar = (vertical) ? strip.removeFromBottom(level) : strip.removeFromLeft(level);
+
+        fillBridgeRect(pixels, area, bar,   highlight);
+        fillBridgeRect(pixels, area, strip, background);
+
+        if (vertical)
+        {
+
+            if (peakShown)
+                fillBridgeRect(pixels, area, juce::Rectangle<int>(start, height - peak - peakSize / 2, end - start, peakSize), foreground);
+
+            if (isChannelOver(channel))
+                fillBridgeRect(pixels, area, juce::Rectangle<int>(start, 0, end - start, overSize), foreground);
+
+            fillBridgeRect(pixels, area, juce::Rectangle<int>(end - 1, 0, 1, height), background);
+
+        }
+        else
+        {
+
+            if (peakShown)
+                fillBridgeRect(pixels, area, juce::Rectangle<int>(peak - peakSize / 2, start, peakSize, end - start), foreground);
+
+            if (isChannelOver(channel))
+                fillBridgeRect(pixels, area, juce::Rectangle<int>(width - overSize, start, overSize, end - start), foreground);
+
+            fillBridgeRect(pixels, area, juce::Rectangle<int>(0, end - 1, width, 1), background);
+
+        }
+
+    }
+
+    // The remainder left over by the integer channel size
+    const int channelsEnd = juce::roundToInt(numChannels * channelSize);
+
+    if (vertical)
+    {
+
+        fillBridgeRect(pixels, area, juce::Rectangle<int>(channelsEnd, 0, width - channelsEnd, height), background);
+
+    }
+    else
+    {
+
+        fillBridgeRect(pixels, area, juce::Rectangle<int>(0, channelsEnd, width, height - channelsEnd), background);
+
+    }
+
+}
+
+void HackAudio::MeterBridge::paint(juce::Graphics& g)
+{
+
+    paintChromeBackground(g);
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    const juce::Rectangle<int> indicatorArea = getIndicatorArea();
+
+    const int imageWidth  = juce::roundToInt(indicatorArea.getWidth() * scale);
+    const int imageHeight = juce::roundToInt(indicatorArea.getHeight() * scale);
+
+    if (imageWidth > 0 && imageHeight > 0)
+    {
+
+        if (!bridgeImage.isValid() || bridgeImage.getWidth() != imageWidth || bridgeImage.getHeight() != imageHeight || scale != bridgeScale)
+        {
+
+            bridgeImage = juce::Image(juce::Image::ARGB, imageWidth, imageHeight, false);
+            bridgeScale = scale;
+
+            renderChannels(bridgeImage.getBounds());
+
+        }
+        else
+        {
+
+            // The image persists between paints, so only the pixels under the clip need updating
+            const juce::Rectangle<float> clipArea = (g.getClipBounds() - indicatorArea.getPosition()).toFloat() * bridgeScale;
+
+            renderChannels(clipArea.getSmallestIntegerContainer().expanded(1));
+
+        }
+
+        g.drawImageTransformed(bridgeImage, juce::AffineTransform::scale(1.0f / bridgeScale).translated((float)indicatorArea.getX(), (float)indicatorArea.getY()));
+
+    }
+
+    paintHistory(g);
+    paintChromeForeground(g);
+
+}
@@ -0,0 +1,61 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HACK_AUDIO_METERBRIDGE_H
+#define HACK_AUDIO_METERBRIDGE_H
+
+namespace HackAudio
+{
+
+/**
+ A HackAudio::Meter for large channel counts. Every channel is rasterised straight into one
+ image's pixels in a single pass instead of through juce::Graphics, and each refresh repaints a
+ single rectangle covering all the channels that changed. The styles, calibrations and sources
+ are all set up the same way as on a regular meter
+*/
+class MeterBridge : public Meter
+{
+
+public:
+
+    MeterBridge();
+    ~MeterBridge();
+
+private:
+
+    void repaintChannels(const juce::RectangleList<int>& dirtyAreas) override;
+
+    void renderChannels(juce::Rectangle<int> area);
+
+    void paint(juce::Graphics& g) override;
+
+    juce::Image bridgeImage;
+    float       bridgeScale;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterBridge)
+
+};
+
+}
+
+#endif
@@ -65,21 +65,6 @@ struct DattorroReverb : public HackAudio::Diagram
     HackAudio::Label decay_1_label;
     HackAudio::Label decay_2_label;
 
-
-    HackAudio::Diagrams::AllpassFilter apf_1_diag;
-    HackAudio::Diagrams::AllpassFilter apf_2_diag;
-    HackAudio::Diagrams::AllpassFilter apf_3_diag;
-    HackAudio::Diagrams::AllpassFilter apf_4_diag;
-    HackAudio::Diagrams::AllpassFilter apf_5_diag;
-    HackAudio::Diagrams::AllpassFilter apf_6_diag;
-    HackAudio::Diagrams::AllpassFilter apf_7_diag;
-    HackAudio::Diagrams::AllpassFilter apf_8_diag;
-    
-    HackAudio::Diagrams::DampingFilter fbd_1_diag;
-    HackAudio::Diagrams::DampingFilter fbd_2_diag;
-    HackAudio::Diagrams::DampingFilter fbd_3_diag;
-
-
     DattorroReverb()
     {
 
@@ -194,18 +179,18 @@ struct DattorroReverb : public HackAudio::Diagram
         addDiagramOutput(fb1);
         addDiagramOutput(fb2);
 
-        setSubDiagram(apf_1_label, apf_1_diag);
-        setSubDiagram(apf_2_label, apf_2_diag);
-        setSubDiagram(apf_3_label, apf_3_diag);
-        setSubDiagram(apf_4_label, apf_4_diag);
-        setSubDiagram(apf_5_label, apf_5_diag);
-        setSubDiagram(apf_6_label, apf_6_diag);
-        setSubDiagram(apf_7_label, apf_7_diag);
-        setSubDiagram(apf_8_label, apf_8_diag);
-        
-        setSubDiagram(fbd_1_label, fbd_1_diag);
-        setSubDiagram(fbd_2_label, fbd_2_diag);
-        setSubDiagram(fbd_3_label, fbd_3_diag);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_1_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_2_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_3_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_4_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_5_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_6_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_7_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_8_label);
+        
+        setSubDiagram<HackAudio::Diagrams::DampingFilter>(fbd_1_label);
+        setSubDiagram<HackAudio::Diagrams::DampingFilter>(fbd_2_label);
+        setSubDiagram<HackAudio::Diagrams::DampingFilter>(fbd_3_label);
 
         setName("Dattorro Plate Reverb");
 
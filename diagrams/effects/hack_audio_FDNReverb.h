@@ -48,10 +48,6 @@ struct FDNReverb : public HackAudio::Diagram
     HackAudio::Label matrix_label;
     HackAudio::Label fbGain_label;
     
-    HackAudio::Diagrams::Moddelay moddelay_1_diag;
-    HackAudio::Diagrams::Moddelay moddelay_2_diag;
-    HackAudio::Diagrams::Moddelay moddelay_3_diag;
-    HackAudio::Diagrams::Moddelay moddelay_4_diag;
     ///
 
     FDNReverb()
@@ -125,10 +121,10 @@ struct FDNReverb : public HackAudio::Diagram
 
         setName("Feed-back Delay Network Reverb");
         
-        setSubDiagram(delay_1_label, moddelay_1_diag);
-        setSubDiagram(delay_2_label, moddelay_2_diag);
-        setSubDiagram(delay_3_label, moddelay_3_diag);
-        setSubDiagram(delay_4_label, moddelay_4_diag);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(delay_1_label);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(delay_2_label);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(delay_3_label);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(delay_4_label);
 
     }
 
@@ -56,12 +56,6 @@ struct GardnerlargeReverb : public HackAudio::Diagram
     HackAudio::Diagram::Junction node1;
     HackAudio::Diagram::Junction node2;
 
-    HackAudio::Diagrams::BiquadFilter lpf_diag;
-    HackAudio::Diagrams::AllpassFilter apf_1_diag;
-    HackAudio::Diagrams::AllpassFilter apf_2_diag;
-    HackAudio::Diagrams::NestedallpassFilter napf_1_diag;
-    HackAudio::Diagrams::NestedtwoFilter napf_2_diag;
-
     GardnerlargeReverb()
     {
 
@@ -169,11 +163,11 @@ struct GardnerlargeReverb : public HackAudio::Diagram
         
         setName("Gardner Large Reverb");
         
-        setSubDiagram(lpf_label,lpf_diag);
-        setSubDiagram(apf_1_label,apf_1_diag);
-        setSubDiagram(apf_2_label,apf_2_diag);
-        setSubDiagram(napf_1_label,napf_1_diag);
-        setSubDiagram(napf_2_label,napf_2_diag);
+        setSubDiagram<HackAudio::Diagrams::BiquadFilter>(lpf_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_1_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_2_label);
+        setSubDiagram<HackAudio::Diagrams::NestedallpassFilter>(napf_1_label);
+        setSubDiagram<HackAudio::Diagrams::NestedtwoFilter>(napf_2_label);
     }
 
 };
@@ -53,11 +53,6 @@ struct GardnermediumReverb : public HackAudio::Diagram
     HackAudio::Diagram::Junction node1;
     HackAudio::Diagram::Junction node2;
 
-    HackAudio::Diagrams::BiquadFilter lpf_diag;
-    HackAudio::Diagrams::AllpassFilter apf_diag;
-    HackAudio::Diagrams::NestedtwoFilter napf_1_diag;
-    HackAudio::Diagrams::NestedallpassFilter napf_2_diag;
-
     GardnermediumReverb()
     {
 
@@ -159,10 +154,10 @@ struct GardnermediumReverb : public HackAudio::Diagram
         
         setName("Gardner Medium Reverb");
         
-        setSubDiagram(lpf_label, lpf_diag);
-        setSubDiagram(apf_label, apf_diag);
-        setSubDiagram(napf_1_label, napf_1_diag);
-        setSubDiagram(napf_2_label, napf_2_diag);
+        setSubDiagram<HackAudio::Diagrams::BiquadFilter>(lpf_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_label);
+        setSubDiagram<HackAudio::Diagrams::NestedtwoFilter>(napf_1_label);
+        setSubDiagram<HackAudio::Diagrams::NestedallpassFilter>(napf_2_label);
     }
 
 };
@@ -44,11 +44,6 @@ struct GardnersmallReverb : public HackAudio::Diagram
     HackAudio::Diagram::Junction node1;
     HackAudio::Diagram::Junction node2;
 
-    HackAudio::Diagrams::BiquadFilter lpf_diag;
-    HackAudio::Diagrams::NestedtwoFilter napf_1_diag;
-    HackAudio::Diagrams::NestedallpassFilter napf_2_diag;
-
-
     GardnersmallReverb()
     {
 
@@ -126,9 +121,9 @@ struct GardnersmallReverb : public HackAudio::Diagram
         setName("Gardner Small Reverb");
         
         
-        setSubDiagram(lpf_label, lpf_diag);
-        setSubDiagram(napf_1_label, napf_1_diag);
-        setSubDiagram(napf_2_label, napf_2_diag);
+        setSubDiagram<HackAudio::Diagrams::BiquadFilter>(lpf_label);
+        setSubDiagram<HackAudio::Diagrams::NestedtwoFilter>(napf_1_label);
+        setSubDiagram<HackAudio::Diagrams::NestedallpassFilter>(napf_2_label);
         
     }
 
@@ -41,20 +41,6 @@ struct MoorerReverb : public HackAudio::Diagram
     HackAudio::Label apf_2_label;
     HackAudio::Label apf_3_label;
 
-    HackAudio::Diagrams::EarlyReflections earlyRef_diag;
-    
-    HackAudio::Diagrams::LPCombFilter comb_2_diag;
-    HackAudio::Diagrams::LPCombFilter comb_3_diag;
-    HackAudio::Diagrams::LPCombFilter comb_4_diag;
-    HackAudio::Diagrams::LPCombFilter comb_5_diag;
-    HackAudio::Diagrams::LPCombFilter comb_6_diag;
-    HackAudio::Diagrams::LPCombFilter comb_7_diag;
-
-
-    HackAudio::Diagrams::AllpassFilter apf_1_diag;
-    HackAudio::Diagrams::AllpassFilter apf_2_diag;
-    HackAudio::Diagrams::AllpassFilter apf_3_diag;
-
     MoorerReverb()
     {
         earlyRef_label.setPlaceholder("ER");
@@ -105,18 +91,18 @@ struct MoorerReverb : public HackAudio::Diagram
 
         addDiagramOutput(apf_3_label);
 
-        setSubDiagram(comb_2_label, comb_2_diag);
-        setSubDiagram(comb_3_label, comb_3_diag);
-        setSubDiagram(comb_4_label, comb_4_diag);
-        setSubDiagram(comb_5_label, comb_5_diag);
-        setSubDiagram(comb_6_label, comb_6_diag);
-        setSubDiagram(comb_7_label, comb_7_diag);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_2_label);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_3_label);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_4_label);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_5_label);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_6_label);
+        setSubDiagram<HackAudio::Diagrams::LPCombFilter>(comb_7_label);
 
-        setSubDiagram(apf_1_label, apf_1_diag);
-        setSubDiagram(apf_2_label, apf_2_diag);
-        setSubDiagram(apf_3_label, apf_3_diag);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_1_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_2_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_3_label);
 
-        setSubDiagram(earlyRef_label, earlyRef_diag);
+        setSubDiagram<HackAudio::Diagrams::EarlyReflections>(earlyRef_label);
         
         setName("Moorer Reverb");
 
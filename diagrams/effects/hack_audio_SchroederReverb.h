@@ -42,19 +42,6 @@ struct SchroederReverb : public HackAudio::Diagram
     HackAudio::Label apf_2_label;
     HackAudio::Label apf_3_label;
 
-    HackAudio::Diagrams::CombFilter comb_1_diag;
-    HackAudio::Diagrams::CombFilter comb_2_diag;
-    HackAudio::Diagrams::CombFilter comb_3_diag;
-    HackAudio::Diagrams::CombFilter comb_4_diag;
-    HackAudio::Diagrams::CombFilter comb_5_diag;
-    HackAudio::Diagrams::CombFilter comb_6_diag;
-    HackAudio::Diagrams::CombFilter comb_7_diag;
-    HackAudio::Diagrams::CombFilter comb_8_diag;
-
-    HackAudio::Diagrams::AllpassFilter apf_1_diag;
-    HackAudio::Diagrams::AllpassFilter apf_2_diag;
-    HackAudio::Diagrams::AllpassFilter apf_3_diag;
-
     SchroederReverb()
     {
 
@@ -109,18 +96,18 @@ struct SchroederReverb : public HackAudio::Diagram
 
         addDiagramOutput(apf_3_label);
 
-        setSubDiagram(comb_1_label, comb_1_diag);
-        setSubDiagram(comb_2_label, comb_2_diag);
-        setSubDiagram(comb_3_label, comb_3_diag);
-        setSubDiagram(comb_4_label, comb_4_diag);
-        setSubDiagram(comb_5_label, comb_5_diag);
-        setSubDiagram(comb_6_label, comb_6_diag);
-        setSubDiagram(comb_7_label, comb_7_diag);
-        setSubDiagram(comb_8_label, comb_8_diag);
-
-        setSubDiagram(apf_1_label, apf_1_diag);
-        setSubDiagram(apf_2_label, apf_2_diag);
-        setSubDiagram(apf_3_label, apf_3_diag);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_1_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_2_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_3_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_4_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_5_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_6_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_7_label);
+        setSubDiagram<HackAudio::Diagrams::CombFilter>(comb_8_label);
+
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_1_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_2_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_3_label);
 
         setName("Schroeder Reverb");
 
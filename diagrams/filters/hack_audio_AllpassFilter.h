@@ -38,8 +38,6 @@ struct AllpassFilter : public HackAudio::Diagram
     HackAudio::Label ff_gain;
     HackAudio::Diagram::Junction ff_mult;
     HackAudio::Diagram::Junction ff_node;
-    
-    HackAudio::Diagrams::Moddelay moddelay_diag;
 
     AllpassFilter()
     {
@@ -82,7 +80,7 @@ struct AllpassFilter : public HackAudio::Diagram
 
         setName("All-Pass Filter");
         
-        setSubDiagram(main_delay, moddelay_diag);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(main_delay);
 
     }
 
@@ -33,8 +33,6 @@ struct CombFilter : public HackAudio::Diagram
 
     HackAudio::Label fb_gain;
     HackAudio::Diagram::Junction fb_node;
-    
-    HackAudio::Diagrams::Moddelay moddelay_diag;
 
     CombFilter()
     {
@@ -63,7 +61,7 @@ struct CombFilter : public HackAudio::Diagram
 
         setName("Feed-Back Comb Filter");
         
-        setSubDiagram(main_delay, moddelay_diag);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(main_delay);
 
     }
 
@@ -38,8 +38,6 @@ struct LPCombFilter : public HackAudio::Diagram
     HackAudio::Label delay_2;
     HackAudio::Label fb_gain2;
     HackAudio::Diagram::Junction fb_2_node;
-    
-    HackAudio::Diagrams::Moddelay moddelay_diag;
 
     LPCombFilter()
     {
@@ -84,7 +82,7 @@ struct LPCombFilter : public HackAudio::Diagram
 
         setName("Low-Pass, Feed-Back Comb Filter");
 
-        setSubDiagram(delay_1, moddelay_diag);
+        setSubDiagram<HackAudio::Diagrams::Moddelay>(delay_1);
     }
 
 };
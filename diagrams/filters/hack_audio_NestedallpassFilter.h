@@ -40,8 +40,6 @@ struct NestedallpassFilter : public HackAudio::Diagram
     HackAudio::Diagram::Junction ff_node;
     
     HackAudio::Label apf_label;
-    
-    HackAudio::Diagrams::AllpassFilter apf_diag;
 
     NestedallpassFilter()
     {
@@ -87,7 +85,7 @@ struct NestedallpassFilter : public HackAudio::Diagram
 
         setName("Nested All-Pass Filter");
         
-        setSubDiagram(apf_label, apf_diag);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_label);
 
     }
 
@@ -41,9 +41,6 @@ struct NestedtwoFilter : public HackAudio::Diagram
     
     HackAudio::Label apf_1_label;
     HackAudio::Label apf_2_label;
-    
-    HackAudio::Diagrams::AllpassFilter apf_1_diag;
-    HackAudio::Diagrams::AllpassFilter apf_2_diag;
 
     NestedtwoFilter()
     {
@@ -92,8 +89,8 @@ struct NestedtwoFilter : public HackAudio::Diagram
 
         setName("Double-Nested, All-Pass Filter");
         
-        setSubDiagram(apf_1_label, apf_1_diag);
-        setSubDiagram(apf_2_label, apf_2_diag);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_1_label);
+        setSubDiagram<HackAudio::Diagrams::AllpassFilter>(apf_2_label);
 
     }
 
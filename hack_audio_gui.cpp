@@ -59,8 +59,14 @@
 #include "components/hack_audio_Button.cpp"
 #include "components/hack_audio_Label.cpp"
 #include "components/hack_audio_Meter.cpp"
+#include "components/hack_audio_MeterBridge.cpp"
 #include "components/hack_audio_Graph.cpp"
 
+#include "layout/hack_audio_DiagramLayout.cpp"
 #include "layout/hack_audio_Diagram.cpp"
 #include "layout/hack_audio_Viewport.cpp"
 //#include "layout/hack_audio_FlexBox.cpp"
+
+#if HACK_AUDIO_ENABLE_BENCHMARKS
+#include "utils/hack_audio_Benchmark.cpp"
+#endif
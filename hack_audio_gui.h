@@ -46,6 +46,17 @@ END_JUCE_MODULE_DECLARATION
 
 // =============================================================================
 
+/** Config: HACK_AUDIO_ENABLE_BENCHMARKS
+
+    Builds HackAudio::Benchmark, which paints components offscreen to measure their cost.
+    It's meant for test and CI builds, so it's left out of plugins by default.
+*/
+#ifndef HACK_AUDIO_ENABLE_BENCHMARKS
+ #define HACK_AUDIO_ENABLE_BENCHMARKS 0
+#endif
+
+// =============================================================================
+
 #include "utils/hack_audio_Colours.h"
 #include "utils/hack_audio_Fonts.h"
 #include "utils/hack_audio_NavigationButton.h"
@@ -55,12 +66,18 @@ END_JUCE_MODULE_DECLARATION
 #include "components/hack_audio_Button.h"
 #include "components/hack_audio_Label.h"
 #include "components/hack_audio_Meter.h"
+#include "components/hack_audio_MeterBridge.h"
 #include "components/hack_audio_Graph.h"
 
+#include "layout/hack_audio_DiagramLayout.h"
 #include "layout/hack_audio_Diagram.h"
 #include "layout/hack_audio_Viewport.h"
 //#include "layout/hack_audio_FlexBox.h"
 
 #include "diagrams/hack_audio_Diagrams.h"
 
+#if HACK_AUDIO_ENABLE_BENCHMARKS
+#include "utils/hack_audio_Benchmark.h"
+#endif
+
 #endif
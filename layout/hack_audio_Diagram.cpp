@@ -108,6 +108,9 @@ HackAudio::Diagram::Diagram()
 
     moveGuard = false;
 
+    pathsValid  = true;
+    extentValid = true;
+
     setInterceptsMouseClicks(false, true);
 
     setBufferedToImage(true);
@@ -117,6 +120,8 @@ HackAudio::Diagram::Diagram()
 HackAudio::Diagram::~Diagram()
 {
 
+    cancelArrangement();
+
 }
 
 void HackAudio::Diagram::addDiagramInput(juce::Component& component)
@@ -126,7 +131,8 @@ void HackAudio::Diagram::addDiagramInput(juce::Component& component)
 
     inputComponents.addIfNotAlreadyThere(&component);
 
-    updateChildren();
+    updateChildVisibility(&component);
+    updateSize();
 
     if (getParentComponent())
     {
@@ -142,7 +148,8 @@ void HackAudio::Diagram::removeDiagramInput(juce::Component& component)
 
     inputComponents.removeFirstMatchingValue(&component);
 
-    updateChildren();
+    updateChildVisibility(&component);
+    updateSize();
 
     if (getParentComponent())
     {
@@ -167,7 +174,8 @@ void HackAudio::Diagram::addDiagramOutput(juce::Component& component)
 
     outputComponents.addIfNotAlreadyThere(&component);
 
-    updateChildren();
+    updateChildVisibility(&component);
+    updateSize();
 
     if (getParentComponent())
     {
@@ -183,7 +191,8 @@ void HackAudio::Diagram::removeDiagramOutput(juce::Component& component)
 
     outputComponents.removeFirstMatchingValue(&component);
 
-    updateChildren();
+    updateChildVisibility(&component);
+    updateSize();
 
     if (getParentComponent())
     {
@@ -209,24 +218,9 @@ void HackAudio::Diagram::connect(juce::Component& source, juce::Component& desti
     addAndMakeVisible(source);
     addAndMakeVisible(destination);
 
-    if(connections.contains(&source))
-    {
-
-        juce::Array<juce::Component*> newArray = connections[&source];
-        newArray.addIfNotAlreadyThere(&destination);
-        connections.set(&source, newArray);
+    addConnection(source, destination);
 
-    }
-    else
-    {
-
-        juce::Array<juce::Component*> newArray;
-        newArray.add(&destination);
-        connections.set(&source, newArray);
-
-    }
-
-    updateChildren();
+    updateSize();
 
 }
 
@@ -240,43 +234,23 @@ void HackAudio::Diagram::connect(HackAudio::Diagram::Junction& source, juce::Com
 
     source.outputDirections.set(&destination, directionFromSource);
 
-    if(connections.contains(&source))
-    {
-
-        juce::Array<juce::Component*> newArray = connections[&source];
-        newArray.addIfNotAlreadyThere(&destination);
-        connections.set(&source, newArray);
-
-    }
-    else
-    {
+    int edge = addConnection(source, destination);
 
-        juce::Array<juce::Component*> newArray;
-        newArray.add(&destination);
-        connections.set(&source, newArray);
+    connections.getEdgeReference(edge).direction = directionFromSource;
 
-    }
+    invalidateRoute(edge);
 
-    updateChildren();
+    updateSize();
 
 }
 
 void HackAudio::Diagram::disconnect(juce::Component& source, juce::Component& destination)
 {
 
-    if (connections.contains(&source))
+    if (removeConnection(source, destination))
     {
 
-        juce::Array<juce::Component*> newArray = connections[&source];
-        newArray.removeFirstMatchingValue(&destination);
-        connections.set(&source, newArray);
-        updateChildren();
-
-    }
-    else
-    {
-
-        return;
+        updateSize();
 
     }
 
@@ -285,24 +259,34 @@ void HackAudio::Diagram::disconnect(juce::Component& source, juce::Component& de
 void HackAudio::Diagram::disconnectInputs(juce::Component& component)
 {
 
-    for(juce::HashMap<juce::Component*, juce::Array<juce::Component*>>::Iterator it (connections); it.next();)
-    {
+    int vertex = connections.getVertex(&component);
 
-        juce::Component* source = it.getKey();
+    if (vertex != -1)
+    {
 
-        juce::Array<juce::Component*> newArray = it.getValue();
+        const juce::Array<int>& inputs = connections.getVertexReference(vertex).inputs;
 
-        if (newArray.removeAllInstancesOf(&component))
+        while (!inputs.isEmpty())
         {
 
-            connections.set(source, newArray);
+            int edge = inputs.getLast();
+
+            juce::Component* source = connections.getVertexReference(connections.getEdgeReference(edge).source).component;
+
+            retractRoute(edge);
+
+            connections.removeEdge(edge);
+
+            updateChildVisibility(source);
 
         }
 
     }
 
     inputComponents.removeFirstMatchingValue(&component);
-    updateChildren();
+
+    updateChildVisibility(&component);
+    updateSize();
 
 }
 
@@ -311,107 +295,87 @@ void HackAudio::Diagram::disconnectOutputs(juce::Component& component)
 
     outputComponents.removeFirstMatchingValue(&component);
 
-    if (connections.contains(&component))
-    {
-
-        connections.remove(&component);
-        updateChildren();
+    int vertex = connections.getVertex(&component);
 
-    }
-    else
+    if (vertex != -1)
     {
 
-        return;
+        const juce::Array<int>& outputs = connections.getVertexReference(vertex).outputs;
 
-    }
+        while (!outputs.isEmpty())
+        {
 
-}
+            int edge = outputs.getLast();
 
-void HackAudio::Diagram::toggle(juce::Component& source, juce::Component& destination)
-{
+            juce::Component* destination = connections.getVertexReference(connections.getEdgeReference(edge).destination).component;
 
-    if (connections.contains(&source))
-    {
+            retractRoute(edge);
 
-        juce::Array<juce::Component*> newArray = connections[&source];
-        (newArray.contains(&destination)) ? newArray.removeFirstMatchingValue(&destination) : newArray.add(&destination);
-        connections.set(&source, newArray);
-        updateChildren();
+            connections.removeEdge(edge);
 
-    }
-    else
-    {
+            updateChildVisibility(destination);
 
-        return;
+        }
 
     }
 
+    updateChildVisibility(&component);
+    updateSize();
+
 }
 
-void HackAudio::Diagram::swap(juce::Component& source, juce::Component& destinationOne, juce::Component& destinationTwo)
+void HackAudio::Diagram::toggle(juce::Component& source, juce::Component& destination)
 {
 
-    if (connections.contains(&source))
+    if (connections.getVertex(&source) == -1) { return; }
+
+    if (!removeConnection(source, destination))
     {
 
-        juce::Array<juce::Component*> newArray = connections[&source];
+        addConnection(source, destination);
 
-        bool stateOne = newArray.contains(&destinationOne);
-        bool stateTwo = newArray.contains(&destinationTwo);
+    }
 
-        if (stateOne != stateTwo)
-        {
+    updateSize();
+
+}
 
-            (stateOne) ? newArray.removeFirstMatchingValue(&destinationOne) : newArray.add(&destinationOne);
-            (stateTwo) ? newArray.removeFirstMatchingValue(&destinationTwo) : newArray.add(&destinationTwo);
+void HackAudio::Diagram::swap(juce::Component& source, juce::Component& destinationOne, juce::Component& destinationTwo)
+{
 
-            connections.set(&source, newArray);
-            repaint();
+    bool stateOne = connections.getEdge(&source, &destinationOne) != -1;
+    bool stateTwo = connections.getEdge(&source, &destinationTwo) != -1;
 
-        }
-        else
-        {
+    if (stateOne == stateTwo) { return; }
 
-            return;
+    if (stateOne)
+    {
 
-        }
+        removeConnection(source, destinationOne);
+        addConnection(source, destinationTwo);
 
     }
     else
     {
 
-        return;
+        addConnection(source, destinationOne);
+        removeConnection(source, destinationTwo);
 
     }
 
+    updateSize();
+
 }
 
 void HackAudio::Diagram::reroute(juce::Component& source, juce::Component& oldDestination, juce::Component& newDestination)
 {
 
-    if (connections.contains(&source))
+    if (removeConnection(source, oldDestination))
     {
 
-        juce::Array<juce::Component*> newArray = connections[&source];
-
-        if (newArray.removeAllInstancesOf(&oldDestination))
-        {
-
-            newArray.addIfNotAlreadyThere(&newDestination);
-            connections.set(&source, newArray);
-            repaint();
-
-        }
-        else
-        {
-            return;
-        }
-
-    }
-    else
-    {
+        addConnection(source, newDestination);
 
-        return;
+        updateSize();
 
     }
 
@@ -420,822 +384,1708 @@ void HackAudio::Diagram::reroute(juce::Component& source, juce::Component& oldDe
 void HackAudio::Diagram::setSubDiagram(juce::Component& source, HackAudio::Diagram& subDiagram)
 {
 
-    jassert(getIndexOfChildComponent(&source) != -1);    /* Warning: Subdiagram Trigger Component Must Be A Child Of Your Diagram */
-    jassert(dynamic_cast<HackAudio::Label*>(&source));    /* Warning: Sources May Only Be HackAudio::Labels */
+    registerSubDiagram(source, &subDiagram, nullptr);
 
-    dynamic_cast<HackAudio::Label*>(&source)->highlightStatus = true;
+}
+
+void HackAudio::Diagram::setSubDiagram(juce::Component& source, SubDiagramFactory factory)
+{
+
+    jassert(factory);    /* Warning: Subdiagram Factory Is Empty */
 
-    submap.set(&source, &subDiagram);
+    registerSubDiagram(source, nullptr, factory);
 
 }
 
-void HackAudio::Diagram::updateSize()
+HackAudio::Diagram* HackAudio::Diagram::getSubDiagram(juce::Component& source)
 {
 
-    if (!isVisible()) { return; }
-
-    moveGuard = true;
+    if (!submap.contains(&source)) { return nullptr; }
 
-    int minX = 0x0FFFFFFF;
-    int minY = 0x0FFFFFFF;
-    int maxX = 0xF0000000;
-    int maxY = 0xF0000000;
+    SubDiagram* s = submap[&source];
 
-    for (int i = 0; i < getNumChildComponents(); ++i)
+    if (!s->diagram)
     {
 
-        juce::Component* c = getChildComponent(i);
+        s->built = s->factory();
+        s->diagram = s->built.get();
 
-        if (!c->isVisible())
-        {
+        jassert(s->diagram);    /* Warning: Subdiagram Factory Returned Nothing */
 
-            continue;
+    }
 
-        }
+    return s->diagram;
 
-        minX = std::min(c->getX(), minX);
-        minY = std::min(c->getY(), minY);
+}
 
-        maxX = std::max(c->getRight(), maxX);
-        maxY = std::max(c->getBottom(), maxY);
+void HackAudio::Diagram::arrange(int layerSpacing, int nodeSpacing)
+{
 
-    }
+    cancelArrangement();
 
-    if (!connectionPaths.isEmpty())
+    if (!arrangementPool)
     {
-        juce::Rectangle<float> p = connectionPaths.getBounds();
 
-        minX = std::min((int)p.getX(), minX); // Argh, juce::Rectangle<float> -> juce::Rectangle<int> casting
-        minY = std::min((int)p.getY(), minY);
-
-        maxX = std::max((int)p.getRight() + 2, maxX);
-        maxY = std::max((int)p.getBottom() + 2, maxY);  /* +2 to account for path stroke size */
+        arrangementPool.reset(new juce::SharedResourcePointer<ArrangementPool>());
 
     }
 
-    if (minX != 0 || minY != 0)
+    arrangement.reset(new Arrangement(*this));
+
+    DiagramLayout& layout = arrangement->layout;
+    layout.setSpacing(layerSpacing, nodeSpacing);
+
+    // Only visible, connected children take part, everything else stays where it is
+    juce::HeapBlock<int> vertexNodes(juce::jmax(1, connections.getNumVertexSlots()));
+
+    for (int vertex = 0; vertex < connections.getNumVertexSlots(); ++vertex)
     {
 
-        for (int i = 0; i < getNumChildComponents(); ++i)
-        {
+        vertexNodes[vertex] = -1;
 
-            juce::Component* c = getChildComponent(i);
-            c->setTopLeftPosition(c->getX() - minX, c->getY() - minY);
+        if (!connections.isVertexActive(vertex)) { continue; }
 
-        }
+        juce::Component* c = connections.getVertexReference(vertex).component;
+
+        if (c->getParentComponent() != this || !c->isVisible()) { continue; }
+
+        vertexNodes[vertex] = layout.addNode(c->getWidth(), c->getHeight());
+        arrangement->components.add(c);
 
     }
 
-    if (minX == 0x0FFFFFFFF || minY == 0x0FFFFFFFF || maxX == 0xF0000000 || maxY == 0xF0000000)
+    for (int edge = 0; edge < connections.getNumEdgeSlots(); ++edge)
     {
 
-        minX = 0;
-        minY = 0;
-        maxX = 0;
-        maxY = 0;
+        if (!connections.isEdgeActive(edge)) { continue; }
 
-    }
+        const ConnectionGraph::Edge& e = connections.getEdgeReference(edge);
 
-    juce::Rectangle<int> newBounds = juce::Rectangle<int>(getX() + minX, getY() + minY, maxX - minX, maxY - minY);
+        int source      = vertexNodes[e.source];
+        int destination = vertexNodes[e.destination];
 
-    if (newBounds != getBounds())
-    {
+        if (source == -1 || destination == -1) { continue; }
 
-        setBounds(newBounds);
+        layout.addEdge(source, destination);
+
+        Arrangement::Connection c;
+        c.edge        = edge;
+        c.source      = arrangement->components[source];
+        c.destination = arrangement->components[destination];
+
+        arrangement->connections.add(c);
 
     }
 
-    moveGuard = false;
+    (*arrangementPool)->addJob(arrangement.get(), false);
 
 }
 
-void HackAudio::Diagram::updateConnections()
+bool HackAudio::Diagram::isArranging() const
 {
 
-    bool orphanedConnections = false;
+    return arrangement != nullptr;
 
-    for(juce::HashMap<juce::Component*, juce::Array<juce::Component*>>::Iterator it (connections); it.next();)
-    {
+}
 
-        juce::Component* source = it.getKey();
+void HackAudio::Diagram::registerSubDiagram(juce::Component& source, HackAudio::Diagram* subDiagram, SubDiagramFactory factory)
+{
 
-        juce::Array<juce::Component*> destinations = it.getValue();
+    jassert(getIndexOfChildComponent(&source) != -1);    /* Warning: Subdiagram Trigger Component Must Be A Child Of Your Diagram */
+    jassert(dynamic_cast<HackAudio::Label*>(&source));    /* Warning: Sources May Only Be HackAudio::Labels */
 
-        if (getIndexOfChildComponent(source) == -1)
-        {
+    dynamic_cast<HackAudio::Label*>(&source)->highlightStatus = true;
 
-            if (getDiagramInputs().contains(source)) { removeDiagramInput(*source); }
-            if (getDiagramOutputs().contains(source)) { removeDiagramOutput(*source); }
+    if (submap.contains(&source))
+    {
 
-            source->removeComponentListener(this);
+        subDiagrams.removeObject(submap[&source]);
 
-            connections.remove(source);
+    }
 
-            orphanedConnections = true;
+    SubDiagram* s = new SubDiagram();
+    s->diagram = subDiagram;
+    s->factory = factory;
 
-            continue;
+    subDiagrams.add(s);
+    submap.set(&source, s);
 
-        }
-        else
-        {
+}
 
-            for (int i = 0; i < destinations.size(); ++i)
-            {
+bool HackAudio::Diagram::canReleaseSubDiagram(const HackAudio::Diagram& subDiagram) const
+{
 
-                juce::Component* c = destinations[i];
+    for (int i = 0; i < subDiagrams.size(); ++i)
+    {
 
-                if (getIndexOfChildComponent(c) == -1)
-                {
+        if (subDiagrams[i]->built.get() == &subDiagram) { return true; }
 
-                    if (getDiagramInputs().contains(c)) { removeDiagramInput(*c); }
-                    if (getDiagramOutputs().contains(c)) { removeDiagramOutput(*c); }
+    }
 
-                    c->removeComponentListener(this);
+    return false;
 
-                    destinations.remove(i);
+}
 
-                    orphanedConnections = true;
+void HackAudio::Diagram::releaseSubDiagram(const HackAudio::Diagram& subDiagram)
+{
 
-                }
+    for (int i = 0; i < subDiagrams.size(); ++i)
+    {
 
-            }
+        SubDiagram* s = subDiagrams[i];
 
-        }
-        
-        if (orphanedConnections)
+        if (s->built.get() == &subDiagram)
         {
 
-            connections.set(source, destinations);
+            s->diagram = nullptr;
+            s->built.reset();
+            return;
 
         }
-        
+
     }
-    
-    if (orphanedConnections)
+
+}
+
+void HackAudio::Diagram::cancelArrangement()
+{
+
+    if (arrangement)
     {
 
-        repaint();
+        (*arrangementPool)->removeJob(arrangement.get(), true, -1);
+        arrangement.reset();
 
     }
 
-    updateSize();
+    cancelPendingUpdate();
 
 }
 
-void HackAudio::Diagram::updateChildren()
+void HackAudio::Diagram::handleAsyncUpdate()
 {
 
-    for (int i = 0; i < getNumChildComponents(); ++i)
-    {
+    if (!arrangement || !arrangement->finished) { return; }
 
-        juce::Component* c = getChildComponent(i);
+    // The job may still be on its way out of the pool, so wait for that before it's deleted
+    (*arrangementPool)->removeJob(arrangement.get(), false, -1);
 
-        bool childHasConnections = false;
+    std::unique_ptr<Arrangement> finishedArrangement (arrangement.release());
 
-        if (inputComponents.contains(c) || outputComponents.contains(c))
-        {
+    const DiagramLayout& layout = finishedArrangement->layout;
 
-            childHasConnections = true;
+    // Anything removed from the diagram since the snapshot was taken is skipped
+    moveGuard = true;
 
-        }
+    for (int node = 0; node < finishedArrangement->components.size(); ++node)
+    {
 
-        if (connections.contains(c))
+        juce::Component* c = finishedArrangement->components[node];
+
+        if (connections.getVertex(c) != -1 && c->getParentComponent() == this)
         {
 
-            childHasConnections = true;
+            c->setTopLeftPosition(layout.getNodePosition(node));
 
         }
 
-        for(juce::HashMap<juce::Component*, juce::Array<juce::Component*>>::Iterator it (connections); it.next();)
-        {
+    }
 
-            juce::Array<juce::Component*> arr = it.getValue();
+    moveGuard = false;
 
-            if (arr.contains(c))
-            {
+    for (int i = 0; i < finishedArrangement->connections.size(); ++i)
+    {
 
-                childHasConnections = true;
+        const Arrangement::Connection& c = finishedArrangement->connections.getReference(i);
 
-            }
+        if (!connections.isEdgeActive(c.edge)) { continue; }
 
-        }
+        ConnectionGraph::Edge& e = connections.getEdgeReference(c.edge);
 
-        if (!childHasConnections)
+        if (connections.getVertexReference(e.source).component == c.source && connections.getVertexReference(e.destination).component == c.destination)
         {
 
-            c->setVisible(false);
+            e.waypoints = layout.getEdgeWaypoints(i);
 
         }
-        else
+
+    }
+
+    for (int edge = 0; edge < connections.getNumEdgeSlots(); ++edge)
+    {
+
+        if (connections.isEdgeActive(edge))
         {
 
-            c->setVisible(true);
+            invalidateRoute(edge);
 
         }
 
     }
 
+    extentValid = false;
+
     updateSize();
 
 }
 
-void HackAudio::Diagram::childrenChanged()
+int HackAudio::Diagram::addConnection(juce::Component& source, juce::Component& destination)
 {
 
-    for (int i = 0; i < getNumChildComponents(); ++i)
+    int edge = connections.getEdge(&source, &destination);
+
+    if (edge == -1)
     {
 
-        juce::Component* c = getChildComponent(i);
-        c->setColour(HackAudio::backgroundColourId, HackAudio::Colours::Gray);
-        c->addComponentListener(this);
+        // A junction remembers the direction it was connected in, so toggling, swapping or
+        // rerouting a connection back draws it the same way again
+        Junction* sourceIsJunction = dynamic_cast<Junction*>(&source);
 
-    }
+        Junction::Direction direction = Junction::Null;
 
-    updateSize();
-    updateConnections();
+        if (sourceIsJunction && sourceIsJunction->outputDirections.contains(&destination))
+        {
 
-}
+            direction = sourceIsJunction->outputDirections[&destination];
 
-void HackAudio::Diagram::parentHierarchyChanged()
-{
+        }
 
-    updateSize();
-    updateConnections();
+        edge = connections.addEdge(&source, &destination, direction);
 
-}
+        invalidateRoute(edge);
 
-void HackAudio::Diagram::componentMovedOrResized(juce::Component &component, bool wasMoved, bool wasResized)
-{
+        updateChildVisibility(&source);
+        updateChildVisibility(&destination);
 
-    if (!moveGuard)
-    {
+    }
 
-        updateSize();
+    return edge;
 
-    }
-    
 }
 
-void HackAudio::Diagram::paintOverChildren(juce::Graphics& g)
+bool HackAudio::Diagram::removeConnection(juce::Component& source, juce::Component& destination)
 {
 
-    connectionPaths.clear();
+    int edge = connections.getEdge(&source, &destination);
 
-    juce::Array<juce::Point<int>> inputNodes;
-    juce::Array<juce::Point<int>> outputNodes;
+    if (edge == -1) { return false; }
 
-    for(juce::HashMap<juce::Component*, juce::Array<juce::Component*>>::Iterator it (connections); it.next();)
-    {
+    retractRoute(edge);
 
-        juce::Component* source = it.getKey();
+    connections.removeEdge(edge);
 
-        if (!source->isVisible()) { repaint(); continue; }
+    updateChildVisibility(&source);
+    updateChildVisibility(&destination);
 
-        juce::Array<juce::Component*> destinations = it.getValue();
+    return true;
 
-        for (int i = 0; i < destinations.size(); ++i)
-        {
+}
+
+void HackAudio::Diagram::updateSize()
+{
 
-            juce::Component* destination = destinations[i];
+    if (!isVisible()) { return; }
 
-            if (!destination->isVisible()) { repaint(); continue; }
+    moveGuard = true;
 
-            Junction* sourceIsJunction = (dynamic_cast<Junction*>(source));
-            Junction* destinationIsJunction = (dynamic_cast<Junction*>(destination));
+    updateRoutes();
 
-            Junction::Direction sourceDirection = Junction::Null;
+    if (!extentValid)
+    {
 
-            if (sourceIsJunction)
-            {
+        recalculateExtent();
 
-                if (sourceIsJunction->outputDirections.contains(destination))
-                {
+    }
 
-                    sourceDirection = sourceIsJunction->outputDirections[destination];
+    int minX = 0;
+    int minY = 0;
+    int maxX = 0;
+    int maxY = 0;
 
-                }
+    if (!extent.isEmpty())
+    {
 
-            }
+        minX = extent.minX;
+        minY = extent.minY;
+        maxX = extent.maxX;
+        maxY = extent.maxY;
 
-            int sourceX = source->getX() + source->getWidth() / 2;
-            int sourceY = source->getY() + source->getHeight() / 2;
+    }
 
-            int destinationX = destination->getX() + destination->getWidth() / 2;
-            int destinationY = destination->getY() + destination->getHeight() / 2;
+    if (minX != 0 || minY != 0)
+    {
 
-            int diffX = abs(sourceX - destinationX);
-            int diffY = abs(sourceY - destinationY);
+        // Children, their cached areas and the cached routes all shift by the same offset in a single pass
+        for (int i = 0; i < getNumChildComponents(); ++i)
+        {
 
-            int x1, y1, x2, y2;
+            juce::Component* c = getChildComponent(i);
+            c->setTopLeftPosition(c->getX() - minX, c->getY() - minY);
 
-            if (diffY > 8 && sourceY < destinationY)
+            if (c->isVisible())
             {
 
-                if (diffX > 8 && sourceX < destinationX)
-                {
+                childAreas.set(c, c->getBounds());
 
-                    if (sourceIsJunction)
-                    {
+            }
 
+        }
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+        for (int edge = 0; edge < routes.size(); ++edge)
+        {
 
-                            x1 = source->getX() + source->getWidth();
-                            y1 = source->getY() + source->getHeight() / 2;
+            if (connections.isEdgeActive(edge))
+            {
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+                juce::Array<juce::Point<int>>& waypoints = connections.getEdgeReference(edge).waypoints;
 
-                            x1 = source->getX() + source->getWidth() / 2;
-                            y1 = source->getY() + source->getHeight();
+                for (int i = 0; i < waypoints.size(); ++i)
+                {
 
-                        }
+                    waypoints.getReference(i) -= juce::Point<int>(minX, minY);
 
-                    }
-                    else
-                    {
+                }
 
-                        x1 = source->getX() + source->getWidth();
-                        y1 = source->getY() + source->getHeight() / 2;
+            }
 
-                    }
+            Route& r = routes.getReference(edge);
 
-                    if (destinationIsJunction)
-                    {
+            if (r.path.isEmpty()) { continue; }
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+            r.path.applyTransform(juce::AffineTransform::translation((float)-minX, (float)-minY));
+            r.area.translate(-minX, -minY);
 
-                            x2 = destination->getX() + destination->getWidth() / 2;
-                            y2 = destination->getY();
+            r.inputNode  -= juce::Point<int>(minX, minY);
+            r.outputNode -= juce::Point<int>(minX, minY);
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+        }
 
-                            x2 = destination->getX();
-                            y2 = destination->getY() + destination->getHeight() / 2;
+        extent.translate(-minX, -minY);
 
-                        }
+        pathsValid = false;
 
-                    }
-                    else
-                    {
+        repaint();
 
-                        x2 = destination->getX();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+    }
 
-                    }
+    juce::Rectangle<int> newBounds = juce::Rectangle<int>(getX() + minX, getY() + minY, maxX - minX, maxY - minY);
 
-                    if (sourceIsJunction || destinationIsJunction)
-                    {
+    if (newBounds != getBounds())
+    {
 
-                        connectionPaths.startNewSubPath(x1, y1);
+        setBounds(newBounds);
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+    }
 
-                            connectionPaths.cubicTo(x2, y1, x2, y1, x2, y2);
+    moveGuard = false;
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+}
 
-                            connectionPaths.cubicTo(x1, y2, x1, y2, x2, y2);
-                            
-                        }
-                        
-                    }
-                    else
-                    {
+void HackAudio::Diagram::updateExtent(juce::Rectangle<int> oldArea, bool hadOldArea, juce::Rectangle<int> newArea, bool hasNewArea)
+{
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 + 64, y1, x1, y2, x1 + 64, y2);
-                        connectionPaths.startNewSubPath(x1 + 64, y2);
-                        connectionPaths.cubicTo(x1 + 64, y2, x2, y2, x2, y2);
+    if (!extentValid) { return; }
 
-                    }
+    // Growing is a union, but an area leaving the extent's edge may shrink it, which only a rescan can tell
+    if (hadOldArea && extent.isOnEdge(oldArea) && !(hasNewArea && newArea.contains(oldArea)))
+    {
 
-                }
-                else if (diffX > 8 && sourceX > destinationX)
+        extentValid = false;
+        return;
+
+    }
+
+    if (hasNewArea)
+    {
+
+        extent.include(newArea);
+
+    }
+
+}
+
+void HackAudio::Diagram::updateChildArea(juce::Component* component)
+{
+
+    bool hadArea = childAreas.contains(component);
+    bool hasArea = component->isVisible() && component->getParentComponent() == this;
+
+    juce::Rectangle<int> oldArea = (hadArea) ? childAreas[component] : juce::Rectangle<int>();
+    juce::Rectangle<int> newArea = component->getBounds();
+
+    if (hasArea)
+    {
+
+        childAreas.set(component, newArea);
+
+    }
+    else if (hadArea)
+    {
+
+        childAreas.remove(component);
+
+    }
+
+    updateExtent(oldArea, hadArea, newArea, hasArea);
+
+}
+
+void HackAudio::Diagram::recalculateExtent()
+{
+
+    extent.clear();
+    childAreas.clear();
+
+    for (int i = 0; i < getNumChildComponents(); ++i)
+    {
+
+        juce::Component* c = getChildComponent(i);
+
+        if (!c->isVisible())
+        {
+
+            continue;
+
+        }
+
+        childAreas.set(c, c->getBounds());
+        extent.include(c->getBounds());
+
+    }
+
+    for (int edge = 0; edge < routes.size(); ++edge)
+    {
+
+        const Route& r = routes.getReference(edge);
+
+        if (!r.path.isEmpty() && connections.isEdgeActive(edge))
+        {
+
+            extent.include(r.area);
+
+        }
+
+    }
+
+    extentValid = true;
+
+}
+
+void HackAudio::Diagram::updateConnections()
+{
+
+    for (int vertex = 0; vertex < connections.getNumVertexSlots(); ++vertex)
+    {
+
+        if (!connections.isVertexActive(vertex)) { continue; }
+
+        const ConnectionGraph::Vertex& v = connections.getVertexReference(vertex);
+
+        if (v.component->getParentComponent() == this) { continue; }
+
+        removeOrphan(vertex);
+
+    }
+
+    updateSize();
+
+}
+
+void HackAudio::Diagram::removeOrphan(int vertex)
+{
+
+    const ConnectionGraph::Vertex& v = connections.getVertexReference(vertex);
+
+    juce::Component* c = v.component;
+
+    // The orphan's neighbours may have lost their last connection along with it
+    juce::Array<juce::Component*> neighbours;
+
+    for (int i = 0; i < v.outputs.size(); ++i)
+    {
+
+        neighbours.add(connections.getVertexReference(connections.getEdgeReference(v.outputs[i]).destination).component);
+
+    }
+
+    for (int i = 0; i < v.inputs.size(); ++i)
+    {
+
+        neighbours.add(connections.getVertexReference(connections.getEdgeReference(v.inputs[i]).source).component);
+
+    }
+
+    for (int i = 0; i < v.outputs.size(); ++i) { retractRoute(v.outputs[i]); }
+    for (int i = 0; i < v.inputs.size(); ++i)  { retractRoute(v.inputs[i]); }
+
+    inputComponents.removeFirstMatchingValue(c);
+    outputComponents.removeFirstMatchingValue(c);
+
+    c->removeComponentListener(this);
+
+    connections.removeVertex(vertex);
+
+    updateChildArea(c);
+
+    for (int i = 0; i < neighbours.size(); ++i)
+    {
+
+        updateChildVisibility(neighbours[i]);
+
+    }
+
+}
+
+void HackAudio::Diagram::updateChildVisibility(juce::Component* component)
+{
+
+    if (component->getParentComponent() != this) { return; }
+
+    bool childHasConnections = inputComponents.contains(component) || outputComponents.contains(component) || connections.isConnected(component);
+
+    if (component->isVisible() != childHasConnections)
+    {
+
+        moveGuard = true;
+
+        component->setVisible(childHasConnections);
+
+        moveGuard = false;
+
+        updateChildArea(component);
+        invalidateRoutes(component);
+
+    }
+
+}
+
+void HackAudio::Diagram::childrenChanged()
+{
+
+    for (int i = 0; i < getNumChildComponents(); ++i)
+    {
+
+        juce::Component* c = getChildComponent(i);
+        c->setColour(HackAudio::backgroundColourId, HackAudio::Colours::Gray);
+        c->addComponentListener(this);
+
+    }
+
+    // Children were added or removed, neither of which the cached child areas can describe
+    extentValid = false;
+
+    updateSize();
+    updateConnections();
+
+}
+
+void HackAudio::Diagram::parentHierarchyChanged()
+{
+
+    updateSize();
+    updateConnections();
+
+}
+
+void HackAudio::Diagram::componentMovedOrResized(juce::Component &component, bool wasMoved, bool wasResized)
+{
+
+    if (!moveGuard)
+    {
+
+        updateChildArea(&component);
+        invalidateRoutes(&component);
+        updateSize();
+
+    }
+    
+}
+
+void HackAudio::Diagram::componentBeingDeleted(juce::Component& component)
+{
+
+    int vertex = connections.getVertex(&component);
+
+    if (vertex != -1)
+    {
+
+        // Junctions connected to the component mustn't apply its direction to whatever is
+        // allocated in its place
+        const ConnectionGraph::Vertex& v = connections.getVertexReference(vertex);
+
+        for (int i = 0; i < v.inputs.size(); ++i)
+        {
+
+            Junction* source = connections.getVertexReference(connections.getEdgeReference(v.inputs[i]).source).junction;
+
+            if (source)
+            {
+
+                source->outputDirections.remove(&component);
+
+            }
+
+        }
+
+        removeOrphan(vertex);
+
+    }
+
+    inputComponents.removeFirstMatchingValue(&component);
+    outputComponents.removeFirstMatchingValue(&component);
+
+}
+
+void HackAudio::Diagram::componentVisibilityChanged(juce::Component& component)
+{
+
+    if (!moveGuard)
+    {
+
+        updateChildArea(&component);
+        invalidateRoutes(&component);
+        updateSize();
+
+    }
+
+}
+
+void HackAudio::Diagram::invalidateRoute(int edge)
+{
+
+    while (routes.size() <= edge)
+    {
+
+        routes.add(Route());
+
+    }
+
+    Route& r = routes.getReference(edge);
+
+    if (!r.dirty)
+    {
+
+        r.dirty = true;
+        dirtyRoutes.add(edge);
+
+    }
+
+    repaint();
+
+}
+
+void HackAudio::Diagram::invalidateRoutes(juce::Component* component)
+{
+
+    int vertex = connections.getVertex(component);
+
+    if (vertex == -1) { return; }
+
+    const ConnectionGraph::Vertex& v = connections.getVertexReference(vertex);
+
+    for (int i = 0; i < v.outputs.size(); ++i)
+    {
+
+        invalidateRoute(v.outputs[i]);
+
+    }
+
+    for (int i = 0; i < v.inputs.size(); ++i)
+    {
+
+        invalidateRoute(v.inputs[i]);
+
+    }
+
+}
+
+void HackAudio::Diagram::retractRoute(int edge)
+{
+
+    if (edge >= routes.size()) { return; }
+
+    Route& r = routes.getReference(edge);
+
+    if (!r.path.isEmpty())
+    {
+
+        updateExtent(r.area, true, juce::Rectangle<int>(), false);
+
+    }
+
+    r.path.clear();
+
+    r.hasInputNode  = false;
+    r.hasOutputNode = false;
+
+    pathsValid = false;
+
+    repaint();
+
+}
+
+void HackAudio::Diagram::updateRoutes()
+{
+
+    if (dirtyRoutes.isEmpty()) { return; }
+
+    for (int i = 0; i < dirtyRoutes.size(); ++i)
+    {
+
+        int edge = dirtyRoutes[i];
+
+        Route& r = routes.getReference(edge);
+
+        r.dirty = false;
+
+        if (!connections.isEdgeActive(edge)) { continue; }
+
+        bool hadArea = !r.path.isEmpty();
+        juce::Rectangle<int> oldArea = r.area;
+
+        routeConnection(edge);
+
+        juce::Rectangle<float> p = r.path.getBounds();
+
+        // +2 to account for path stroke size
+        r.area = juce::Rectangle<int>::leftTopRightBottom((int)p.getX(), (int)p.getY(), (int)p.getRight() + 2, (int)p.getBottom() + 2);
+
+        updateExtent(oldArea, hadArea, r.area, !r.path.isEmpty());
+
+    }
+
+    dirtyRoutes.clearQuick();
+
+    pathsValid = false;
+
+}
+
+void HackAudio::Diagram::routeConnection(int edge)
+{
+
+    Route& r = routes.getReference(edge);
+
+    r.path.clear();
+
+    r.hasInputNode  = false;
+    r.hasOutputNode = false;
+
+    juce::Path& path = r.path;
+
+    const ConnectionGraph::Edge& e = connections.getEdgeReference(edge);
+
+    const ConnectionGraph::Vertex& sourceVertex      = connections.getVertexReference(e.source);
+    const ConnectionGraph::Vertex& destinationVertex = connections.getVertexReference(e.destination);
+
+    juce::Component* source      = sourceVertex.component;
+    juce::Component* destination = destinationVertex.component;
+
+    if (!source->isVisible() || !destination->isVisible()) { return; }
+
+    Junction* sourceIsJunction      = sourceVertex.junction;
+    Junction* destinationIsJunction = destinationVertex.junction;
+
+    Junction::Direction sourceDirection = (sourceIsJunction) ? e.direction : Junction::Null;
+
+    if (!e.waypoints.isEmpty())
+    {
+
+        // Leave and arrive on whichever sides face the first and last corners given by arrange()
+        juce::Point<int> first = e.waypoints.getFirst();
+        juce::Point<int> last  = e.waypoints.getLast();
+
+        juce::Point<int> start;
+        juce::Point<int> end;
+
+        start.x = (first.x >= source->getX() + source->getWidth() / 2) ? source->getRight() : source->getX();
+        start.y = source->getY() + source->getHeight() / 2;
+
+        end.x = (last.x <= destination->getX() + destination->getWidth() / 2) ? destination->getX() : destination->getRight();
+        end.y = destination->getY() + destination->getHeight() / 2;
+
+        // Components moved since the layout are met with an extra corner, so every segment stays orthogonal
+        juce::Point<int> previous = start;
+
+        path.startNewSubPath(start.x, start.y);
+
+        for (int i = 0; i < e.waypoints.size(); ++i)
+        {
+
+            juce::Point<int> w = e.waypoints[i];
+
+            if (previous.x != w.x && previous.y != w.y)
+            {
+
+                path.lineTo(w.x, previous.y);
+
+            }
+
+            path.lineTo(w.x, w.y);
+            previous = w;
+
+        }
+
+        if (previous.x != end.x && previous.y != end.y)
+        {
+
+            path.lineTo(previous.x, end.y);
+
+        }
+
+        path.lineTo(end.x, end.y);
+
+        r.inputNode  = end;
+        r.outputNode = start;
+
+        r.hasInputNode  = (destinationIsJunction == nullptr);
+        r.hasOutputNode = (sourceIsJunction == nullptr);
+
+        return;
+
+    }
+
+    int sourceX = source->getX() + source->getWidth() / 2;
+    int sourceY = source->getY() + source->getHeight() / 2;
+
+    int destinationX = destination->getX() + destination->getWidth() / 2;
+    int destinationY = destination->getY() + destination->getHeight() / 2;
+
+    int diffX = abs(sourceX - destinationX);
+    int diffY = abs(sourceY - destinationY);
+
+    int x1, y1, x2, y2;
+
+    if (diffY > 8 && sourceY < destinationY)
+    {
+
+        if (diffX > 8 && sourceX < destinationX)
+        {
+
+            if (sourceIsJunction)
+            {
+
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x1 = source->getX() + source->getWidth();
+                    y1 = source->getY() + source->getHeight() / 2;
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x1 = source->getX() + source->getWidth() / 2;
+                    y1 = source->getY() + source->getHeight();
+
+                }
+
+            }
+            else
+            {
+
+                x1 = source->getX() + source->getWidth();
+                y1 = source->getY() + source->getHeight() / 2;
+
+            }
+
+            if (destinationIsJunction)
+            {
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x2 = destination->getX() + destination->getWidth() / 2;
+                    y2 = destination->getY();
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x2 = destination->getX();
+                    y2 = destination->getY() + destination->getHeight() / 2;
+
+                }
+
+            }
+            else
+            {
+
+                x2 = destination->getX();
+                y2 = destination->getY() + destination->getHeight() / 2;
+
+            }
+
+            if (sourceIsJunction || destinationIsJunction)
+            {
+
+                path.startNewSubPath(x1, y1);
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    path.cubicTo(x2, y1, x2, y1, x2, y2);
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    path.cubicTo(x1, y2, x1, y2, x2, y2);
+                    
+                }
+                
+            }
+            else
+            {
+
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 + 64, y1, x1, y2, x1 + 64, y2);
+                path.startNewSubPath(x1 + 64, y2);
+                path.cubicTo(x1 + 64, y2, x2, y2, x2, y2);
+
+            }
+
+        }
+        else if (diffX > 8 && sourceX > destinationX)
+        {
+
+
+            if (sourceIsJunction)
+            {
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x1 = source->getX();
+                    y1 = source->getY() + source->getHeight() / 2;
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x1 = source->getX() + source->getWidth() / 2;
+                    y1 = source->getY() + source->getHeight();
+
+                }
+
+            }
+            else
+            {
+
+                x1 = source->getX();
+                y1 = source->getY() + source->getHeight() / 2;
+
+            }
+
+
+            if (destinationIsJunction)
+            {
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x2 = destination->getX() + destination->getWidth() / 2;
+                    y2 = destination->getY();
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x2 = destination->getX() + destination->getWidth();
+                    y2 = destination->getY() + destination->getWidth() / 2;
+
+                }
+
+            }
+            else
+            {
+
+                x2 = destination->getX() + destination->getWidth();
+                y2 = destination->getY() + destination->getHeight() / 2;
+
+            }
+
+            if (sourceIsJunction || destinationIsJunction)
+            {
+
+                path.startNewSubPath(x1, y1);
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    path.cubicTo(x2, y1, x2, y1, x2, y2);
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    path.cubicTo(x1, y2, x1, y2, x2, y2);
+
+                }
+
+            }
+            else
+            {
+
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 - 64, y1, x1, y2, x1 - 64, y2);
+                path.startNewSubPath(x1 - 64, y2);
+                path.cubicTo(x1 - 64, y2, x2, y2, x2, y2);
+                
+            }
+
+        }
+        else if (diffX <= 8 || sourceX == destinationX)
+        {
+
+            if (sourceIsJunction && destinationIsJunction)
+            {
+
+                x1 = source->getX() + source->getWidth() / 2;
+                y1 = source->getY() + source->getHeight();
+
+                x2 = destination->getX() + destination->getWidth() / 2;
+                y2 = destination->getY();
+
+                path.startNewSubPath(x1, y1);
+                path.quadraticTo((x1 + x2) / 2, (y1 + y2) / 2, x2, y2);
+
+            }
+            else
+            {
+
+                x1 = source->getX() + source->getWidth();
+                y1 = source->getY() + source->getHeight() / 2;
+
+                x2 = destination->getX() + destination->getWidth();
+                y2 = destination->getY() + destination->getHeight() / 2;
+
+                int midY = (y1 + y2) / 2;
+
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 + 64, y1, x1 + 64, y1, x1 + 64, midY);
+                path.startNewSubPath(x1 + 64, midY);
+                path.cubicTo(x1 + 64, y2, x1 + 64, y2, x2, y2);
+
+            }
+            
+        }
+
+    }
+    else if (diffY > 8 && sourceY > destinationY)
+    {
+
+        if (diffX > 8 && sourceX < destinationX)
+        {
+
+            if (sourceIsJunction)
+            {
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x1 = source->getX() + source->getWidth();
+                    y1 = source->getY() + source->getHeight() / 2;
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x1 = source->getX() + source->getWidth() / 2;
+                    y1 = source->getY();
+                    
+                }
+
+            }
+            else
+            {
+
+                x1 = source->getX() + source->getWidth();
+                y1 = source->getY() + source->getHeight() / 2;
+
+            }
+
+            if (destinationIsJunction)
+            {
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    x2 = destination->getX() + destination->getWidth() / 2;
+                    y2 = destination->getY() + destination->getHeight();
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
+
+                    x2 = destination->getX();
+                    y2 = destination->getY() + destination->getHeight() / 2;
+
+                }
+
+            }
+            else
+            {
+
+                x2 = destination->getX();
+                y2 = destination->getY() + destination->getHeight() / 2;
+
+            }
+
+            if (sourceIsJunction || destinationIsJunction)
+            {
+
+                path.startNewSubPath(x1, y1);
+
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
+
+                    path.cubicTo(x2, y1, x2, y1, x2, y2);
+
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
                 {
 
+                    path.cubicTo(x1, y2, x1, y2, x2, y2);
+                    
+                }
 
-                    if (sourceIsJunction)
-                    {
+            }
+            else
+            {
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 + 64, y1, x1, y2, x1 + 64, y2);
+                path.startNewSubPath(x1 + 64, y2);
+                path.cubicTo(x1 + 64, y2, x2, y2, x2, y2);
+                
+            }
 
-                            x1 = source->getX();
-                            y1 = source->getY() + source->getHeight() / 2;
+        }
+        else if (diffX > 8 && sourceX > destinationX)
+        {
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+            if (sourceIsJunction)
+            {
 
-                            x1 = source->getX() + source->getWidth() / 2;
-                            y1 = source->getY() + source->getHeight();
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
 
-                        }
+                    x1 = source->getX();
+                    y1 = source->getY() + source->getHeight() / 2;
 
-                    }
-                    else
-                    {
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
 
-                        x1 = source->getX();
-                        y1 = source->getY() + source->getHeight() / 2;
+                    x1 = source->getX() + source->getWidth() / 2;
+                    y1 = source->getY();
 
-                    }
+                }
 
+            }
+            else
+            {
 
-                    if (destinationIsJunction)
-                    {
+                x1 = source->getX();
+                y1 = source->getY() + source->getHeight() / 2;
+                
+            }
+            
+            if (destinationIsJunction)
+            {
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
 
-                            x2 = destination->getX() + destination->getWidth() / 2;
-                            y2 = destination->getY();
+                    x2 = destination->getX() + destination->getWidth() / 2;
+                    y2 = destination->getY() + destination->getHeight();
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
 
-                            x2 = destination->getX() + destination->getWidth();
-                            y2 = destination->getY() + destination->getWidth() / 2;
+                    x2 = destination->getX() + destination->getWidth();
+                    y2 = destination->getY() + destination->getHeight() / 2;
 
-                        }
+                }
 
-                    }
-                    else
-                    {
+            }
+            else
+            {
 
-                        x2 = destination->getX() + destination->getWidth();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+                x2 = destination->getX() + destination->getWidth();
+                y2 = destination->getY() + destination->getHeight() / 2;
 
-                    }
+            }
 
-                    if (sourceIsJunction || destinationIsJunction)
-                    {
+            if (sourceIsJunction || destinationIsJunction)
+            {
 
-                        connectionPaths.startNewSubPath(x1, y1);
+                path.startNewSubPath(x1, y1);
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+                if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
+                {
 
-                            connectionPaths.cubicTo(x2, y1, x2, y1, x2, y2);
+                    path.cubicTo(x2, y1, x2, y1, x2, y2);
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+                }
+                else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
+                {
 
-                            connectionPaths.cubicTo(x1, y2, x1, y2, x2, y2);
+                    path.cubicTo(x1, y2, x1, y2, x2, y2);
+                    
+                }
 
-                        }
+            }
+            else
+            {
 
-                    }
-                    else
-                    {
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 - 64, y1, x1, y2, x1 - 64, y2);
+                path.startNewSubPath(x1 - 64, y2);
+                path.cubicTo(x1 - 64, y2, x2, y2, x2, y2);
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 - 64, y1, x1, y2, x1 - 64, y2);
-                        connectionPaths.startNewSubPath(x1 - 64, y2);
-                        connectionPaths.cubicTo(x1 - 64, y2, x2, y2, x2, y2);
-                        
-                    }
+            }
+            
+        }
+        else if (diffX <= 8 || sourceX == destinationX)
+        {
 
-                }
-                else if (diffX <= 8 || sourceX == destinationX)
-                {
+            if (sourceIsJunction && destinationIsJunction)
+            {
 
-                    if (sourceIsJunction && destinationIsJunction)
-                    {
+                x1 = source->getX() + source->getWidth() / 2;
+                y1 = source->getY();
 
-                        x1 = source->getX() + source->getWidth() / 2;
-                        y1 = source->getY() + source->getHeight();
+                x2 = destination->getX() + destination->getWidth() / 2;
+                y2 = destination->getY() + destination->getHeight();
 
-                        x2 = destination->getX() + destination->getWidth() / 2;
-                        y2 = destination->getY();
+                path.startNewSubPath(x1, y1);
+                path.quadraticTo((x1 + x2) / 2, (y1 + y2) / 2, x2, y2);
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.quadraticTo((x1 + x2) / 2, (y1 + y2) / 2, x2, y2);
+            }
+            else
+            {
 
-                    }
-                    else
-                    {
+                x1 = source->getX() + source->getWidth();
+                y1 = source->getY() + source->getHeight() / 2;
 
-                        x1 = source->getX() + source->getWidth();
-                        y1 = source->getY() + source->getHeight() / 2;
+                x2 = destination->getX() + destination->getWidth();
+                y2 = destination->getY() + destination->getHeight() / 2;
 
-                        x2 = destination->getX() + destination->getWidth();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+                int midY = (y1 + y2) / 2;
 
-                        int midY = (y1 + y2) / 2;
+                path.startNewSubPath(x1, y1);
+                path.cubicTo(x1 + 64, y1, x1 + 64, y1, x1 + 64, midY);
+                path.startNewSubPath(x1 + 64, midY);
+                path.cubicTo(x1 + 64, y2, x1 + 64, y2, x2, y2);
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 + 64, y1, x1 + 64, y1, x1 + 64, midY);
-                        connectionPaths.startNewSubPath(x1 + 64, midY);
-                        connectionPaths.cubicTo(x1 + 64, y2, x1 + 64, y2, x2, y2);
+            }
 
-                    }
-                    
-                }
+        }
 
-            }
-            else if (diffY > 8 && sourceY > destinationY)
-            {
+    }
+    else if (diffY <= 8 || sourceY == destinationY)
+    {
 
-                if (diffX > 8 && sourceX < destinationX)
-                {
+        jassert(diffX > 8);    /* Warning: Components Are Placed Directly On Top Of Each Other */
 
-                    if (sourceIsJunction)
-                    {
+        if (sourceX < destinationX)
+        {
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+            x1 = source->getX() + source->getWidth();
+            y1 = source->getY() + source->getHeight() / 2;
 
-                            x1 = source->getX() + source->getWidth();
-                            y1 = source->getY() + source->getHeight() / 2;
+            x2 = destination->getX();
+            y2 = destination->getY() + destination->getHeight() / 2;
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+        }
+        //TODO: What if sourceX == destinationX ?
+        //This is now covered below, but is it what we want?
+        else /*if (sourceX > destinationX)*/
+        {
 
-                            x1 = source->getX() + source->getWidth() / 2;
-                            y1 = source->getY();
-                            
-                        }
+            x1 = source->getX();
+            y1 = source->getY() + source->getHeight() / 2;
 
-                    }
-                    else
-                    {
+            x2 = destination->getX() + destination->getWidth();
+            y2 = destination->getY() + destination->getHeight() / 2;
 
-                        x1 = source->getX() + source->getWidth();
-                        y1 = source->getY() + source->getHeight() / 2;
+        }
 
-                    }
+        path.startNewSubPath(x1, y1);
+        path.lineTo(x2, y2);
 
-                    if (destinationIsJunction)
-                    {
+    }
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+    r.inputNode  = juce::Point<int>(x2, y2);
+    r.outputNode = juce::Point<int>(x1, y1);
 
-                            x2 = destination->getX() + destination->getWidth() / 2;
-                            y2 = destination->getY() + destination->getHeight();
+    r.hasInputNode  = (destinationIsJunction == nullptr);
+    r.hasOutputNode = (sourceIsJunction == nullptr);
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+}
 
-                            x2 = destination->getX();
-                            y2 = destination->getY() + destination->getHeight() / 2;
+void HackAudio::Diagram::paintOverChildren(juce::Graphics& g)
+{
 
-                        }
+    // Routes are rebuilt by updateSize() whenever a connection or child changes, so this is normally a no-op
+    updateRoutes();
 
-                    }
-                    else
-                    {
+    if (!pathsValid)
+    {
 
-                        x2 = destination->getX();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+        connectionPaths.clear();
 
-                    }
+        inputNodes.clearQuick();
+        outputNodes.clearQuick();
 
-                    if (sourceIsJunction || destinationIsJunction)
-                    {
+        for (int edge = 0; edge < routes.size(); ++edge)
+        {
 
-                        connectionPaths.startNewSubPath(x1, y1);
+            if (!connections.isEdgeActive(edge)) { continue; }
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+            const Route& r = routes.getReference(edge);
 
-                            connectionPaths.cubicTo(x2, y1, x2, y1, x2, y2);
+            connectionPaths.addPath(r.path);
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+            if (r.hasInputNode)  { inputNodes.add(r.inputNode); }
+            if (r.hasOutputNode) { outputNodes.add(r.outputNode); }
 
-                            connectionPaths.cubicTo(x1, y2, x1, y2, x2, y2);
-                            
-                        }
+        }
 
-                    }
-                    else
-                    {
+        pathsValid = true;
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 + 64, y1, x1, y2, x1 + 64, y2);
-                        connectionPaths.startNewSubPath(x1 + 64, y2);
-                        connectionPaths.cubicTo(x1 + 64, y2, x2, y2, x2, y2);
-                        
-                    }
+    }
 
-                }
-                else if (diffX > 8 && sourceX > destinationX)
-                {
+    for (int i = 0; i < inputNodes.size(); ++i)
+    {
 
-                    if (sourceIsJunction)
-                    {
+        juce::Point<int> p = inputNodes[i];
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        g.fillEllipse(p.x - 8, p.y - 8, 16, 16);
+        g.setColour(findColour(HackAudio::backgroundColourId));
+        g.drawEllipse(p.x - 8, p.y - 8, 16, 16, 4);
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+    }
 
-                            x1 = source->getX();
-                            y1 = source->getY() + source->getHeight() / 2;
+    g.setColour(findColour(HackAudio::midgroundColourId));
+    g.strokePath(connectionPaths, juce::PathStrokeType(4));
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+    for (int i = 0; i < outputNodes.size(); ++i)
+    {
 
-                            x1 = source->getX() + source->getWidth() / 2;
-                            y1 = source->getY();
+        juce::Point<int> p = outputNodes[i];
+        g.setColour(findColour(HackAudio::backgroundColourId));
+        g.fillEllipse(p.x - 8, p.y - 8, 16, 16);
+        g.setColour(findColour(HackAudio::midgroundColourId));
+        g.drawEllipse(p.x - 8, p.y - 8, 16, 16, 4);
 
-                        }
+    }
 
-                    }
-                    else
-                    {
+}
 
-                        x1 = source->getX();
-                        y1 = source->getY() + source->getHeight() / 2;
-                        
-                    }
-                    
-                    if (destinationIsJunction)
-                    {
+// ============================================================
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+HackAudio::Diagram::ArrangementPool::ArrangementPool() : juce::ThreadPool(1)
+{
 
-                            x2 = destination->getX() + destination->getWidth() / 2;
-                            y2 = destination->getY() + destination->getHeight();
+}
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+HackAudio::Diagram::ArrangementPool::~ArrangementPool()
+{
 
-                            x2 = destination->getX() + destination->getWidth();
-                            y2 = destination->getY() + destination->getHeight() / 2;
+}
 
-                        }
+HackAudio::Diagram::Arrangement::Arrangement(Diagram& diagram) : juce::ThreadPoolJob("HackAudio Diagram Arrangement"), owner(diagram)
+{
 
-                    }
-                    else
-                    {
+    finished = false;
 
-                        x2 = destination->getX() + destination->getWidth();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+}
 
-                    }
+HackAudio::Diagram::Arrangement::~Arrangement()
+{
 
-                    if (sourceIsJunction || destinationIsJunction)
-                    {
+}
 
-                        connectionPaths.startNewSubPath(x1, y1);
+juce::ThreadPoolJob::JobStatus HackAudio::Diagram::Arrangement::runJob()
+{
 
-                        if (sourceDirection == Junction::Null || sourceDirection == Junction::Horizontal)
-                        {
+    if (layout.perform([this] { return shouldExit(); }))
+    {
 
-                            connectionPaths.cubicTo(x2, y1, x2, y1, x2, y2);
+        finished = true;
+        owner.triggerAsyncUpdate();
 
-                        }
-                        else if (sourceDirection == Junction::Auto || sourceDirection == Junction::Vertical)
-                        {
+    }
 
-                            connectionPaths.cubicTo(x1, y2, x1, y2, x2, y2);
-                            
-                        }
+    return jobHasFinished;
 
-                    }
-                    else
-                    {
+}
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 - 64, y1, x1, y2, x1 - 64, y2);
-                        connectionPaths.startNewSubPath(x1 - 64, y2);
-                        connectionPaths.cubicTo(x1 - 64, y2, x2, y2, x2, y2);
+// ============================================================
 
-                    }
-                    
-                }
-                else if (diffX <= 8 || sourceX == destinationX)
-                {
+HackAudio::Diagram::Route::Route()
+{
 
-                    if (sourceIsJunction && destinationIsJunction)
-                    {
+    hasInputNode  = false;
+    hasOutputNode = false;
 
-                        x1 = source->getX() + source->getWidth() / 2;
-                        y1 = source->getY();
+    dirty = false;
 
-                        x2 = destination->getX() + destination->getWidth() / 2;
-                        y2 = destination->getY() + destination->getHeight();
+}
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.quadraticTo((x1 + x2) / 2, (y1 + y2) / 2, x2, y2);
+HackAudio::Diagram::Extent::Extent()
+{
 
-                    }
-                    else
-                    {
+    clear();
 
-                        x1 = source->getX() + source->getWidth();
-                        y1 = source->getY() + source->getHeight() / 2;
+}
 
-                        x2 = destination->getX() + destination->getWidth();
-                        y2 = destination->getY() + destination->getHeight() / 2;
+void HackAudio::Diagram::Extent::clear()
+{
 
-                        int midY = (y1 + y2) / 2;
+    minX = 0x0FFFFFFF;
+    minY = 0x0FFFFFFF;
+    maxX = (int)0xF0000000;
+    maxY = (int)0xF0000000;
 
-                        connectionPaths.startNewSubPath(x1, y1);
-                        connectionPaths.cubicTo(x1 + 64, y1, x1 + 64, y1, x1 + 64, midY);
-                        connectionPaths.startNewSubPath(x1 + 64, midY);
-                        connectionPaths.cubicTo(x1 + 64, y2, x1 + 64, y2, x2, y2);
+}
 
-                    }
+void HackAudio::Diagram::Extent::include(juce::Rectangle<int> area)
+{
 
-                }
+    minX = std::min(area.getX(), minX);
+    minY = std::min(area.getY(), minY);
 
-            }
-            else if (diffY <= 8 || sourceY == destinationY)
-            {
+    maxX = std::max(area.getRight(), maxX);
+    maxY = std::max(area.getBottom(), maxY);
 
-                jassert(diffX > 8);    /* Warning: Components Are Placed Directly On Top Of Each Other */
+}
 
-                if (sourceX < destinationX)
-                {
+void HackAudio::Diagram::Extent::translate(int deltaX, int deltaY)
+{
 
-                    x1 = source->getX() + source->getWidth();
-                    y1 = source->getY() + source->getHeight() / 2;
+    if (isEmpty()) { return; }
 
-                    x2 = destination->getX();
-                    y2 = destination->getY() + destination->getHeight() / 2;
+    minX += deltaX;
+    minY += deltaY;
+    maxX += deltaX;
+    maxY += deltaY;
 
-                }
-                //TODO: What if sourceX == destinationX ?
-                //This is now covered below, but is it what we want?
-                else /*if (sourceX > destinationX)*/
-                {
+}
 
-                    x1 = source->getX();
-                    y1 = source->getY() + source->getHeight() / 2;
+bool HackAudio::Diagram::Extent::isOnEdge(juce::Rectangle<int> area) const
+{
 
-                    x2 = destination->getX() + destination->getWidth();
-                    y2 = destination->getY() + destination->getHeight() / 2;
+    return area.getX() <= minX || area.getY() <= minY || area.getRight() >= maxX || area.getBottom() >= maxY;
 
-                }
+}
 
-                connectionPaths.startNewSubPath(x1, y1);
-                connectionPaths.lineTo(x2, y2);
+bool HackAudio::Diagram::Extent::isEmpty() const
+{
 
-            }
+    return minX > maxX || minY > maxY;
 
+}
 
-            if (!destinationIsJunction)
-            {
+// ============================================================
 
-                inputNodes.add(juce::Point<int>(x2, y2));
+HackAudio::Diagram::ConnectionGraph::ConnectionGraph()
+{
 
-            }
+}
 
-            if (!sourceIsJunction)
-            {
+int HackAudio::Diagram::ConnectionGraph::getVertex(juce::Component* component) const
+{
 
-                outputNodes.add(juce::Point<int>(x1, y1));
-                
-            }
+    return (vertexIndex.contains(component)) ? vertexIndex[component] : -1;
+
+}
+
+int HackAudio::Diagram::ConnectionGraph::getEdge(juce::Component* source, juce::Component* destination) const
+{
+
+    int sourceVertex      = getVertex(source);
+    int destinationVertex = getVertex(destination);
+
+    if (sourceVertex == -1 || destinationVertex == -1) { return -1; }
+
+    const juce::Array<int>& outputs = vertices.getReference(sourceVertex).outputs;
+
+    for (int i = 0; i < outputs.size(); ++i)
+    {
+
+        if (edges.getReference(outputs[i]).destination == destinationVertex)
+        {
+
+            return outputs[i];
 
         }
 
     }
 
-    for (int i = 0; i < inputNodes.size(); ++i)
+    return -1;
+
+}
+
+int HackAudio::Diagram::ConnectionGraph::addEdge(juce::Component* source, juce::Component* destination, Junction::Direction direction)
+{
+
+    int sourceVertex      = getVertex(source);
+    int destinationVertex = getVertex(destination);
+
+    if (sourceVertex == -1)      { sourceVertex = addVertex(source); }
+    if (destinationVertex == -1) { destinationVertex = addVertex(destination); }
+
+    Edge e;
+    e.source      = sourceVertex;
+    e.destination = destinationVertex;
+    e.direction   = direction;
+
+    int edge;
+
+    if (freeEdges.isEmpty())
     {
 
-        juce::Point<int> p = inputNodes[i];
-        g.setColour(findColour(HackAudio::midgroundColourId));
-        g.fillEllipse(p.x - 8, p.y - 8, 16, 16);
-        g.setColour(findColour(HackAudio::backgroundColourId));
-        g.drawEllipse(p.x - 8, p.y - 8, 16, 16, 4);
+        edge = edges.size();
+        edges.add(e);
 
     }
+    else
+    {
 
-    g.setColour(findColour(HackAudio::midgroundColourId));
-    g.strokePath(connectionPaths, juce::PathStrokeType(4));
+        edge = freeEdges.removeAndReturn(freeEdges.size() - 1);
+        edges.set(edge, e);
 
-    for (int i = 0; i < outputNodes.size(); ++i)
+    }
+
+    vertices.getReference(sourceVertex).outputs.add(edge);
+    vertices.getReference(destinationVertex).inputs.add(edge);
+
+    return edge;
+
+}
+
+void HackAudio::Diagram::ConnectionGraph::removeEdge(int edge)
+{
+
+    jassert(isEdgeActive(edge));
+
+    Edge& e = edges.getReference(edge);
+
+    vertices.getReference(e.source).outputs.removeFirstMatchingValue(edge);
+    vertices.getReference(e.destination).inputs.removeFirstMatchingValue(edge);
+
+    e.source      = -1;
+    e.destination = -1;
+
+    freeEdges.add(edge);
+
+}
+
+void HackAudio::Diagram::ConnectionGraph::removeVertex(int vertex)
+{
+
+    jassert(isVertexActive(vertex));
+
+    Vertex& v = vertices.getReference(vertex);
+
+    while (!v.outputs.isEmpty()) { removeEdge(v.outputs.getLast()); }
+    while (!v.inputs.isEmpty())  { removeEdge(v.inputs.getLast()); }
+
+    vertexIndex.remove(v.component);
+
+    v.component = nullptr;
+    v.junction  = nullptr;
+
+    freeVertices.add(vertex);
+
+}
+
+bool HackAudio::Diagram::ConnectionGraph::isConnected(juce::Component* component) const
+{
+
+    int vertex = getVertex(component);
+
+    if (vertex == -1) { return false; }
+
+    const Vertex& v = vertices.getReference(vertex);
+
+    return !v.outputs.isEmpty() || !v.inputs.isEmpty();
+
+}
+
+int HackAudio::Diagram::ConnectionGraph::getNumVertexSlots() const
+{
+
+    return vertices.size();
+
+}
+
+int HackAudio::Diagram::ConnectionGraph::getNumEdgeSlots() const
+{
+
+    return edges.size();
+
+}
+
+bool HackAudio::Diagram::ConnectionGraph::isVertexActive(int vertex) const
+{
+
+    return vertices.getReference(vertex).component != nullptr;
+
+}
+
+bool HackAudio::Diagram::ConnectionGraph::isEdgeActive(int edge) const
+{
+
+    return edges.getReference(edge).source != -1;
+
+}
+
+const HackAudio::Diagram::ConnectionGraph::Vertex& HackAudio::Diagram::ConnectionGraph::getVertexReference(int vertex) const
+{
+
+    return vertices.getReference(vertex);
+
+}
+
+HackAudio::Diagram::ConnectionGraph::Edge& HackAudio::Diagram::ConnectionGraph::getEdgeReference(int edge)
+{
+
+    return edges.getReference(edge);
+
+}
+
+int HackAudio::Diagram::ConnectionGraph::addVertex(juce::Component* component)
+{
+
+    Vertex v;
+    v.component = component;
+    v.junction  = dynamic_cast<Junction*>(component);
+
+    int vertex;
+
+    if (freeVertices.isEmpty())
     {
 
-        juce::Point<int> p = outputNodes[i];
-        g.setColour(findColour(HackAudio::backgroundColourId));
-        g.fillEllipse(p.x - 8, p.y - 8, 16, 16);
-        g.setColour(findColour(HackAudio::midgroundColourId));
-        g.drawEllipse(p.x - 8, p.y - 8, 16, 16, 4);
+        vertex = vertices.size();
+        vertices.add(v);
 
     }
+    else
+    {
 
-    updateSize();
+        vertex = freeVertices.removeAndReturn(freeVertices.size() - 1);
+        vertices.set(vertex, v);
+
+    }
+
+    vertexIndex.set(component, vertex);
+
+    return vertex;
 
 }
@@ -31,7 +31,8 @@ namespace HackAudio
  A class that displays HackAudio::Labels in a signal flow diagram
 */
 class Diagram : public juce::Component,
-                private juce::ComponentListener
+                private juce::ComponentListener,
+                private juce::AsyncUpdater
 {
 
     friend class Viewport;
@@ -205,28 +206,311 @@ public:
     */
     void setSubDiagram(juce::Component& source, HackAudio::Diagram& subDiagram);
 
+    /**
+     Builds a sub-diagram on demand, the diagram that calls it takes ownership of the result
+    */
+    typedef std::function<std::unique_ptr<HackAudio::Diagram>()> SubDiagramFactory;
+
+    /**
+     Designates a diagram to be expanded when double-clicking the source component, without building it until it's first expanded
+
+     A HackAudio::Viewport may destroy the built diagram again once it's left the traversal, in which case it's rebuilt
+     from the factory the next time it's expanded.
+
+     @param source  the component to double click to expand the diagram
+     @param factory  the function that builds the diagram to expand
+
+     @see Viewport::setSubDiagramCacheSize
+    */
+    void setSubDiagram(juce::Component& source, SubDiagramFactory factory);
+
+    /**
+     Designates a DiagramType to be expanded when double-clicking the source component, built on demand
+
+     The configure callback is run on every diagram that's built, including any rebuilt after a viewport released
+     the last one, so it's the place to customise a nested diagram. Calling this again for the same source replaces
+     the previous designation, e.g. to customise the sub-diagrams a built-in diagram sets up:
+
+     @code
+     reverb.setSubDiagram<HackAudio::Diagrams::Moddelay>(reverb.delay_1_label, [](HackAudio::Diagrams::Moddelay& d)
+     {
+         d.setName("Modulated Delay 1");
+     });
+     @endcode
+
+     @param source  the component to double click to expand the diagram
+     @param configure  an optional function to set up each diagram that's built
+    */
+    template <class DiagramType>
+    void setSubDiagram(juce::Component& source, std::function<void(DiagramType&)> configure = nullptr)
+    {
+
+        setSubDiagram(source, [configure]
+        {
+
+            std::unique_ptr<DiagramType> d (new DiagramType());
+
+            if (configure)
+                configure(*d);
+
+            return std::unique_ptr<HackAudio::Diagram>(std::move(d));
+
+        });
+
+    }
+
+    /**
+     Lays out every connected component automatically, assigning them to layers that flow from left to right,
+     ordering each layer to minimise crossing connections and routing the connections orthogonally between them
+
+     The layout is computed on a background thread from a snapshot of the connections, and applied in a single step
+     on the message thread once it's ready. Calling this again before then abandons the previous layout.
+     Connections keep the routes they were given until they're broken.
+
+     @param layerSpacing  the minimum horizontal gap between layers
+     @param nodeSpacing  the vertical gap between components in the same layer
+
+     @see DiagramLayout
+    */
+    void arrange(int layerSpacing = 48, int nodeSpacing = 24);
+
+    /**
+     Returns true while a layout started by arrange() hasn't been applied yet
+    */
+    bool isArranging() const;
+
 private:
 
+    /**
+     The background thread that arrangements are computed on, shared by every diagram
+    */
+    class ArrangementPool : public juce::ThreadPool
+    {
+
+    public:
+
+        ArrangementPool();
+        ~ArrangementPool();
+
+    };
+
+    /**
+     A snapshot of the diagram's connections being laid out on the ArrangementPool
+    */
+    class Arrangement : public juce::ThreadPoolJob
+    {
+
+    public:
+
+        Arrangement(Diagram& diagram);
+        ~Arrangement();
+
+        JobStatus runJob() override;
+
+        /**
+         The connection a layout edge stands for, and the components it joined when the snapshot was taken
+        */
+        struct Connection
+        {
+            int edge;
+            juce::Component* source;
+            juce::Component* destination;
+        };
+
+        DiagramLayout layout;
+
+        juce::Array<juce::Component*> components;   /**< The component each layout node stands for */
+        juce::Array<Connection> connections;        /**< The connection each layout edge stands for */
+
+        std::atomic<bool> finished;
+
+    private:
+
+        Diagram& owner;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Arrangement)
+
+    };
+
+    /**
+     The diagram's connections, stored as a directed graph with forward and reverse adjacency so that
+     a component's inputs and outputs can be reached without scanning every connection
+
+     Vertex and edge IDs are indices into their arrays and stay valid until the vertex or edge is
+     removed, after which the slot is recycled by the next addition.
+    */
+    class ConnectionGraph
+    {
+
+    public:
+
+        struct Vertex
+        {
+            juce::Component* component;
+            Junction*        junction;      /**< The component as a junction, or nullptr */
+            juce::Array<int> outputs;       /**< IDs of the edges leaving this vertex */
+            juce::Array<int> inputs;        /**< IDs of the edges arriving at this vertex */
+        };
+
+        struct Edge
+        {
+            int source;
+            int destination;
+            Junction::Direction direction;  /**< The axis to draw from when the source is a junction */
+            juce::Array<juce::Point<int>> waypoints;    /**< The corners given by arrange(), or empty to route automatically */
+        };
+
+        ConnectionGraph();
+
+        int getVertex(juce::Component* component) const;
+        int getEdge(juce::Component* source, juce::Component* destination) const;
+
+        int addEdge(juce::Component* source, juce::Component* destination, Junction::Direction direction);
+        void removeEdge(int edge);
+
+        void removeVertex(int vertex);
+
+        bool isConnected(juce::Component* component) const;
+
+        int getNumVertexSlots() const;
+        int getNumEdgeSlots() const;
+
+        bool isVertexActive(int vertex) const;
+        bool isEdgeActive(int edge) const;
+
+        const Vertex& getVertexReference(int vertex) const;
+        Edge& getEdgeReference(int edge);
+
+    private:
+
+        int addVertex(juce::Component* component);
+
+        juce::Array<Vertex> vertices;
+        juce::Array<Edge>   edges;
+
+        juce::Array<int> freeVertices;
+        juce::Array<int> freeEdges;
+
+        juce::HashMap<juce::Component*, int> vertexIndex;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConnectionGraph)
+
+    };
+
+    /**
+     The cached geometry of a single connection, rebuilt only when one of its ends moves
+    */
+    struct Route
+    {
+
+        Route();
+
+        juce::Path path;
+        juce::Rectangle<int> area;      /**< The path's bounds, padded for the stroke */
+
+        juce::Point<int> inputNode;
+        juce::Point<int> outputNode;
+
+        bool hasInputNode;
+        bool hasOutputNode;
+
+        bool dirty;
+
+    };
+
+    /**
+     The running union of every visible child and route, which may still contain zero sized junctions
+    */
+    struct Extent
+    {
+
+        Extent();
+
+        void clear();
+        void include(juce::Rectangle<int> area);
+        void translate(int deltaX, int deltaY);
+
+        bool isOnEdge(juce::Rectangle<int> area) const;
+        bool isEmpty() const;
+
+        int minX, minY, maxX, maxY;
+
+    };
+
+    int addConnection(juce::Component& source, juce::Component& destination);
+    bool removeConnection(juce::Component& source, juce::Component& destination);
+    void removeOrphan(int vertex);
+
     void updateSize();
+    void updateExtent(juce::Rectangle<int> oldArea, bool hadOldArea, juce::Rectangle<int> newArea, bool hasNewArea);
+    void updateChildArea(juce::Component* component);
+    void recalculateExtent();
+
     void updateConnections();
-    void updateChildren();
+    void updateChildVisibility(juce::Component* component);
+
+    void invalidateRoute(int edge);
+    void invalidateRoutes(juce::Component* component);
+    void retractRoute(int edge);
+    void updateRoutes();
+    void routeConnection(int edge);
 
     void childrenChanged() override;
     void parentHierarchyChanged() override;
 
     void componentMovedOrResized(juce::Component& component, bool wasMoved, bool wasResized) override;
+    void componentBeingDeleted(juce::Component& component) override;
+    void componentVisibilityChanged(juce::Component& component) override;
 
     void paintOverChildren(juce::Graphics& g) override;
 
+    void cancelArrangement();
+
+    void registerSubDiagram(juce::Component& source, HackAudio::Diagram* subDiagram, SubDiagramFactory factory);
+
+    /**
+     Returns the diagram expanded by double-clicking the source component, building it first if it came from a factory,
+     or nullptr if the component doesn't expand a diagram. Built diagrams may be released by a Viewport, so only it calls this
+    */
+    HackAudio::Diagram* getSubDiagram(juce::Component& source);
+
+    bool canReleaseSubDiagram(const HackAudio::Diagram& subDiagram) const;
+    void releaseSubDiagram(const HackAudio::Diagram& subDiagram);
+    void handleAsyncUpdate() override;
+
     bool moveGuard;
+    bool pathsValid;
+    bool extentValid;
+
+    Extent extent;
+    juce::HashMap<juce::Component*, juce::Rectangle<int>> childAreas;
 
     juce::Array<juce::Component*> inputComponents;
     juce::Array<juce::Component*> outputComponents;
 
+    juce::Array<Route> routes;
+    juce::Array<int> dirtyRoutes;
+
     juce::Path connectionPaths;
-    juce::HashMap<juce::Component*, juce::Array<juce::Component*>> connections;
+    juce::Array<juce::Point<int>> inputNodes;
+    juce::Array<juce::Point<int>> outputNodes;
+    ConnectionGraph connections;
+
+    /**
+     A diagram expanded from one of the children, either given directly or built on demand from a factory
+    */
+    struct SubDiagram
+    {
+        HackAudio::Diagram* diagram;                /**< The diagram to expand, or nullptr until the factory has built it */
+        SubDiagramFactory factory;
+        std::unique_ptr<HackAudio::Diagram> built;  /**< The diagram the factory built, if it has been */
+    };
+
+    juce::OwnedArray<SubDiagram> subDiagrams;
+    juce::HashMap<juce::Component*, SubDiagram*> submap;
 
-    juce::HashMap<juce::Component*, HackAudio::Diagram*> submap;
+    std::unique_ptr<juce::SharedResourcePointer<ArrangementPool>> arrangementPool;  /**< Taken by the first arrange(), so the thread only starts once it's needed and outlives each arrangement */
+    std::unique_ptr<Arrangement> arrangement;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Diagram)
 
@@ -0,0 +1,1913 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+HackAudio::DiagramLayout::DiagramLayout()
+{
+
+    layerSpacing = 48;
+    nodeSpacing  = 24;
+    numSweeps    = 8;
+    numCrossings = 0;
+    numLayers    = 0;
+    leaveCursor  = 0;
+
+}
+
+HackAudio::DiagramLayout::~DiagramLayout()
+{
+
+}
+
+void HackAudio::DiagramLayout::clear()
+{
+
+    nodes.clear();
+    edges.clear();
+
+    numCrossings = 0;
+    numLayers    = 0;
+
+}
+
+int HackAudio::DiagramLayout::addNode(int width, int height)
+{
+
+    jassert(width >= 0 && height >= 0);
+
+    Node n;
+    n.width  = width;
+    n.height = height;
+    n.layer  = 0;
+    n.x      = 0;
+    n.y      = 0;
+
+    nodes.add(n);
+
+    return nodes.size() - 1;
+
+}
+
+int HackAudio::DiagramLayout::addEdge(int source, int destination)
+{
+
+    jassert(juce::isPositiveAndBelow(source, nodes.size()) && juce::isPositiveAndBelow(destination, nodes.size()));
+
+    Edge e;
+    e.source      = source;
+    e.destination = destination;
+    e.reversed    = false;
+
+    edges.add(e);
+
+    return edges.size() - 1;
+
+}
+
+void HackAudio::DiagramLayout::setSpacing(int newLayerSpacing, int newNodeSpacing)
+{
+
+    jassert(newLayerSpacing >= 0 && newNodeSpacing >= 0);
+
+    layerSpacing = newLayerSpacing;
+    nodeSpacing  = newNodeSpacing;
+
+}
+
+void HackAudio::DiagramLayout::setNumSweeps(int newNumSweeps)
+{
+
+    jassert(newNumSweeps >= 0);
+
+    numSweeps = newNumSweeps;
+
+}
+
+bool HackAudio::DiagramLayout::perform(ExitCheck shouldExit)
+{
+
+    numCrossings = 0;
+    numLayers    = 0;
+
+    if (nodes.isEmpty()) { return true; }
+
+    breakCycles();
+
+    if (!assignLayers(shouldExit)) { return false; }
+
+    if (!buildLayeredGraph(shouldExit)) { return false; }
+
+    if (!orderLayers(shouldExit)) { return false; }
+
+    if (!placeVertices(shouldExit)) { return false; }
+
+    return routeEdges(shouldExit);
+
+}
+
+int HackAudio::DiagramLayout::getNumNodes() const
+{
+
+    return nodes.size();
+
+}
+
+int HackAudio::DiagramLayout::getNumEdges() const
+{
+
+    return edges.size();
+
+}
+
+juce::Point<int> HackAudio::DiagramLayout::getNodePosition(int node) const
+{
+
+    const Node& n = nodes.getReference(node);
+
+    return juce::Point<int>(n.x, n.y);
+
+}
+
+int HackAudio::DiagramLayout::getNodeLayer(int node) const
+{
+
+    return nodes.getReference(node).layer;
+
+}
+
+const juce::Array<juce::Point<int>>& HackAudio::DiagramLayout::getEdgeWaypoints(int edge) const
+{
+
+    return edges.getReference(edge).waypoints;
+
+}
+
+int HackAudio::DiagramLayout::getNumCrossings() const
+{
+
+    return numCrossings;
+
+}
+
+void HackAudio::DiagramLayout::breakCycles()
+{
+
+    const int numNodes = nodes.size();
+    const int numEdges = edges.size();
+
+    // Every node's outgoing edges, grouped by node
+    juce::HeapBlock<int> start(numNodes + 1, true);
+    juce::HeapBlock<int> outgoing(juce::jmax(1, numEdges));
+    juce::HeapBlock<int> indegree(numNodes, true);
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        Edge& edge = edges.getReference(e);
+        edge.reversed = false;
+
+        start[edge.source + 1]++;
+
+        if (edge.source != edge.destination)
+        {
+
+            indegree[edge.destination]++;
+
+        }
+
+    }
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        start[n + 1] += start[n];
+
+    }
+
+    {
+
+        juce::HeapBlock<int> cursor(numNodes);
+
+        for (int n = 0; n < numNodes; ++n)
+        {
+
+            cursor[n] = start[n];
+
+        }
+
+        for (int e = 0; e < numEdges; ++e)
+        {
+
+            outgoing[cursor[edges.getReference(e).source]++] = e;
+
+        }
+
+    }
+
+    // An iterative depth first search, an edge back to a node still on the stack closes a cycle
+    enum { unvisited, onStack, finished };
+
+    juce::HeapBlock<int> state(numNodes, true);
+    juce::HeapBlock<int> stackNodes(numNodes);
+    juce::HeapBlock<int> stackCursors(numNodes);
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+
+        for (int root = 0; root < numNodes; ++root)
+        {
+
+            // Sources go first so that the flow a diagram was drawn with is the one that's kept
+            if (state[root] != unvisited || (pass == 0 && indegree[root] > 0)) { continue; }
+
+            int depth = 0;
+
+            stackNodes[0]   = root;
+            stackCursors[0] = start[root];
+            state[root]     = onStack;
+
+            while (depth >= 0)
+            {
+
+                int node = stackNodes[depth];
+
+                if (stackCursors[depth] == start[node + 1])
+                {
+
+                    state[node] = finished;
+                    --depth;
+                    continue;
+
+                }
+
+                Edge& edge = edges.getReference(outgoing[stackCursors[depth]++]);
+
+                if (edge.destination == node) { continue; }
+
+                if (state[edge.destination] == onStack)
+                {
+
+                    edge.reversed = true;
+
+                }
+                else if (state[edge.destination] == unvisited)
+                {
+
+                    ++depth;
+
+                    stackNodes[depth]   = edge.destination;
+                    stackCursors[depth] = start[edge.destination];
+
+                    state[edge.destination] = onStack;
+
+                }
+
+            }
+
+        }
+
+    }
+
+}
+
+bool HackAudio::DiagramLayout::assignLayers(const ExitCheck& shouldExit)
+{
+
+    const int numNodes = nodes.size();
+    const int numEdges = edges.size();
+
+    juce::HeapBlock<int> start(numNodes + 1, true);
+    juce::HeapBlock<int> successors(juce::jmax(1, numEdges));
+    juce::HeapBlock<int> indegree(numNodes, true);
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        const Edge& edge = edges.getReference(e);
+
+        if (edge.source == edge.destination) { continue; }
+
+        int from = (edge.reversed) ? edge.destination : edge.source;
+        int to   = (edge.reversed) ? edge.source : edge.destination;
+
+        start[from + 1]++;
+        indegree[to]++;
+
+    }
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        start[n + 1] += start[n];
+
+    }
+
+    {
+
+        juce::HeapBlock<int> cursor(numNodes);
+
+        for (int n = 0; n < numNodes; ++n)
+        {
+
+            cursor[n] = start[n];
+
+        }
+
+        for (int e = 0; e < numEdges; ++e)
+        {
+
+            const Edge& edge = edges.getReference(e);
+
+            if (edge.source == edge.destination) { continue; }
+
+            int from = (edge.reversed) ? edge.destination : edge.source;
+            int to   = (edge.reversed) ? edge.source : edge.destination;
+
+            successors[cursor[from]++] = to;
+
+        }
+
+    }
+
+    // Longest path layering, walking the nodes in topological order
+    juce::HeapBlock<int> order(numNodes);
+    juce::HeapBlock<int> remaining(numNodes);
+
+    int head = 0;
+    int tail = 0;
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        nodes.getReference(n).layer = 0;
+        remaining[n] = indegree[n];
+
+        if (indegree[n] == 0)
+        {
+
+            order[tail++] = n;
+
+        }
+
+    }
+
+    while (head < tail)
+    {
+
+        int node  = order[head++];
+        int layer = nodes.getReference(node).layer;
+
+        for (int i = start[node]; i < start[node + 1]; ++i)
+        {
+
+            Node& successor = nodes.getReference(successors[i]);
+
+            successor.layer = juce::jmax(successor.layer, layer + 1);
+
+            if (--remaining[successors[i]] == 0)
+            {
+
+                order[tail++] = successors[i];
+
+            }
+
+        }
+
+    }
+
+    jassert(tail == numNodes);    /* Warning: breakCycles() Left A Cycle Behind */
+
+    /*
+     Longest path layering stretches every edge that doesn't lie on a longest path, which on a tangled
+     diagram leaves most of the layered graph as dummies. Network simplex starts from it and pivots the
+     spanning tree of tight edges until no pivot shortens the edges' total span
+    */
+    rankEdges.clearQuick();
+    rankEdges.ensureStorageAllocated(numEdges);
+
+    incidentStart.clearQuick();
+    incidentStart.insertMultiple(0, 0, numNodes + 1);
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        const Edge& edge = edges.getReference(e);
+
+        if (edge.source == edge.destination) { continue; }
+
+        RankEdge r;
+        r.tail      = (edge.reversed) ? edge.destination : edge.source;
+        r.head      = (edge.reversed) ? edge.source : edge.destination;
+        r.cutValue  = 0;
+        r.treeIndex = -1;
+
+        rankEdges.add(r);
+
+        incidentStart.getReference(r.tail + 1)++;
+        incidentStart.getReference(r.head + 1)++;
+
+    }
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        incidentStart.getReference(n + 1) += incidentStart[n];
+
+    }
+
+    incidentEdges.clearQuick();
+    incidentEdges.insertMultiple(0, 0, incidentStart[numNodes]);
+
+    {
+
+        juce::HeapBlock<int> cursor(numNodes);
+
+        for (int n = 0; n < numNodes; ++n)
+        {
+
+            cursor[n] = incidentStart[n];
+
+        }
+
+        for (int e = 0; e < rankEdges.size(); ++e)
+        {
+
+            const RankEdge& r = rankEdges.getReference(e);
+
+            incidentEdges.set(cursor[r.tail]++, e);
+            incidentEdges.set(cursor[r.head]++, e);
+
+        }
+
+    }
+
+    if (shouldExit && shouldExit()) { return false; }
+
+    treeParent.malloc(numNodes);
+    treeLow.malloc(numNodes);
+    treeLim.malloc(numNodes);
+    treeComponent.malloc(numNodes);
+    postorder.malloc(numNodes);
+    treeStack.malloc(numNodes);
+    treeCursors.malloc(numNodes);
+    treeOrder.malloc(numNodes);
+
+    findFeasibleTree();
+
+    if (shouldExit && shouldExit()) { return false; }
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        treeParent[n] = -1;
+
+    }
+
+    for (int c = 0, first = 0; c < treeRoots.size(); ++c)
+    {
+
+        first = setTreeRanges(treeRoots[c], first);
+
+    }
+
+    // Postorder reaches every subtree before its parent, so each cut value is built from its children's
+    for (int i = 0; i < numNodes; ++i)
+    {
+
+        if (treeParent[postorder[i]] >= 0)
+        {
+
+            setCutValue(treeParent[postorder[i]]);
+
+        }
+
+    }
+
+    leaveCursor = 0;
+
+    for (int leaving = findLeavingEdge(); leaving >= 0; leaving = findLeavingEdge())
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        int entering = findEnteringEdge(leaving);
+
+        if (entering < 0) { break; }
+
+        exchangeTreeEdges(leaving, entering);
+
+    }
+
+    // Every component starts at the leftmost layer
+    for (int c = 0; c < treeRoots.size(); ++c)
+    {
+
+        const int root = treeRoots[c];
+
+        int lowest = nodes.getReference(root).layer;
+
+        for (int i = treeLow[root]; i < treeLim[root]; ++i)
+        {
+
+            lowest = juce::jmin(lowest, nodes.getReference(postorder[i]).layer);
+
+        }
+
+        for (int i = treeLow[root]; i <= treeLim[root]; ++i)
+        {
+
+            nodes.getReference(postorder[i]).layer -= lowest;
+
+        }
+
+    }
+
+    /*
+     Walking back from the sinks, a node with at least as many outputs as inputs is pulled up against its
+     nearest successor. That never stretches more edges than it shortens, so the total span stays minimal,
+     and it keeps a gain feeding a junction deep in the diagram right beside it
+    */
+    for (int i = numNodes - 1; i >= 0; --i)
+    {
+
+        int n = order[i];
+
+        int numOutputs = start[n + 1] - start[n];
+
+        if (numOutputs == 0 || numOutputs < indegree[n]) { continue; }
+
+        int nearest = nodes.getReference(successors[start[n]]).layer;
+
+        for (int j = start[n] + 1; j < start[n + 1]; ++j)
+        {
+
+            nearest = juce::jmin(nearest, nodes.getReference(successors[j]).layer);
+
+        }
+
+        nodes.getReference(n).layer = nearest - 1;
+
+    }
+
+    numLayers = 0;
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        numLayers = juce::jmax(numLayers, nodes.getReference(n).layer + 1);
+
+    }
+
+    return true;
+
+}
+
+void HackAudio::DiagramLayout::findFeasibleTree()
+{
+
+    const int numNodes = nodes.size();
+
+    /*
+     Grows a spanning tree of tight edges out from each component's first node, Prim style. When no edge
+     out of the tree is tight, the whole tree shifts by the smallest slack left, which keeps every edge
+     feasible. The shift is held in offset instead of being applied, so a tree node's layer is stored
+     relative to it, and each edge waits in a heap keyed on its slack at an offset of zero
+    */
+    auto later = [](const TreeCandidate& a, const TreeCandidate& b) { return a.key > b.key; };
+
+    juce::Array<TreeCandidate> outward;    // Edges from a tree node, slack is key - offset
+    juce::Array<TreeCandidate> inward;     // Edges into a tree node, slack is key + offset
+
+    juce::Array<int> members;
+
+    treeEdges.clearQuick();
+    treeRoots.clearQuick();
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        treeComponent[n] = -1;
+
+    }
+
+    for (int root = 0; root < numNodes; ++root)
+    {
+
+        if (treeComponent[root] >= 0) { continue; }
+
+        const int component = treeRoots.size();
+
+        treeRoots.add(root);
+
+        outward.clearQuick();
+        inward.clearQuick();
+        members.clearQuick();
+
+        int offset = 0;
+        int next   = root;
+
+        while (next >= 0)
+        {
+
+            treeComponent[next] = component;
+            members.add(next);
+
+            const int layer = nodes.getReference(next).layer -= offset;
+
+            for (int i = incidentStart[next]; i < incidentStart[next + 1]; ++i)
+            {
+
+                const int e = incidentEdges[i];
+                const RankEdge& r = rankEdges.getReference(e);
+
+                if (r.tail == next && treeComponent[r.head] < 0)
+                {
+
+                    outward.add({ nodes.getReference(r.head).layer - layer - 1, e });
+                    std::push_heap(outward.begin(), outward.end(), later);
+
+                }
+                else if (r.head == next && treeComponent[r.tail] < 0)
+                {
+
+                    inward.add({ layer - nodes.getReference(r.tail).layer - 1, e });
+                    std::push_heap(inward.begin(), inward.end(), later);
+
+                }
+
+            }
+
+            // Edges whose far end joined the tree since they were queued are dropped as they surface
+            while (!outward.isEmpty() && treeComponent[rankEdges.getReference(outward.getFirst().edge).head] >= 0)
+            {
+
+                std::pop_heap(outward.begin(), outward.end(), later);
+                outward.removeLast();
+
+            }
+
+            while (!inward.isEmpty() && treeComponent[rankEdges.getReference(inward.getFirst().edge).tail] >= 0)
+            {
+
+                std::pop_heap(inward.begin(), inward.end(), later);
+                inward.removeLast();
+
+            }
+
+            if (outward.isEmpty() && inward.isEmpty()) { break; }
+
+            int edge;
+
+            if (inward.isEmpty() || (!outward.isEmpty() && outward.getFirst().key - offset <= inward.getFirst().key + offset))
+            {
+
+                edge    = outward.getFirst().edge;
+                offset += outward.getFirst().key - offset;
+                next    = rankEdges.getReference(edge).head;
+
+                std::pop_heap(outward.begin(), outward.end(), later);
+                outward.removeLast();
+
+            }
+            else
+            {
+
+                edge    = inward.getFirst().edge;
+                offset -= inward.getFirst().key + offset;
+                next    = rankEdges.getReference(edge).tail;
+
+                std::pop_heap(inward.begin(), inward.end(), later);
+                inward.removeLast();
+
+            }
+
+            rankEdges.getReference(edge).treeIndex = treeEdges.size();
+            treeEdges.add(edge);
+
+        }
+
+        for (int i = 0; i < members.size(); ++i)
+        {
+
+            nodes.getReference(members[i]).layer += offset;
+
+        }
+
+    }
+
+}
+
+int HackAudio::DiagramLayout::setTreeRanges(int root, int first, const int* reshaped, int numReshaped)
+{
+
+    int depth = 0;
+    int next  = first;
+
+    treeStack[0]   = root;
+    treeCursors[0] = incidentStart[root];
+    treeLow[root]  = first;
+
+    while (depth >= 0)
+    {
+
+        const int node = treeStack[depth];
+
+        if (treeCursors[depth] == incidentStart[node + 1])
+        {
+
+            treeLim[node]   = next;
+            treeOrder[next] = node;
+
+            ++next;
+            --depth;
+            continue;
+
+        }
+
+        const int e = incidentEdges[treeCursors[depth]++];
+        const RankEdge& r = rankEdges.getReference(e);
+
+        if (r.treeIndex < 0 || e == treeParent[node]) { continue; }
+
+        const int child = (r.tail == node) ? r.head : r.tail;
+
+        // A subtree hanging off the same edge and holding none of the reshaped nodes keeps its shape, and is only renumbered
+        if (treeParent[child] == e)
+        {
+
+            bool unchanged = true;
+
+            for (int i = 0; i < numReshaped && unchanged; ++i)
+            {
+
+                unchanged = reshaped[i] < treeLow[child] || reshaped[i] > treeLim[child];
+
+            }
+
+            if (unchanged)
+            {
+
+                const int low   = treeLow[child];
+                const int lim   = treeLim[child];
+                const int shift = next - low;
+
+                for (int p = low; p <= lim; ++p)
+                {
+
+                    const int member = postorder[p];
+
+                    treeLow[member] += shift;
+                    treeLim[member] += shift;
+
+                    treeOrder[p + shift] = member;
+
+                }
+
+                next += lim - low + 1;
+                continue;
+
+            }
+
+        }
+
+        treeParent[child] = e;
+        treeLow[child]    = next;
+
+        ++depth;
+
+        treeStack[depth]   = child;
+        treeCursors[depth] = incidentStart[child];
+
+    }
+
+    // The old numbering is read by renumbered subtrees until the whole range is done
+    for (int p = first; p < next; ++p)
+    {
+
+        postorder[p] = treeOrder[p];
+
+    }
+
+    return next;
+
+}
+
+void HackAudio::DiagramLayout::setCutValue(int rankEdge)
+{
+
+    RankEdge& edge = rankEdges.getReference(rankEdge);
+
+    // The cut splits off the subtree below the edge, whose cut values are already known
+    const int  node     = (treeParent[edge.tail] == rankEdge) ? edge.tail : edge.head;
+    const bool tailSide = (node == edge.tail);
+
+    int sum = 0;
+
+    for (int i = incidentStart[node]; i < incidentStart[node + 1]; ++i)
+    {
+
+        const int e = incidentEdges[i];
+        const RankEdge& r = rankEdges.getReference(e);
+
+        const int  other   = (r.tail == node) ? r.head : r.tail;
+        const bool outside = treeLim[other] < treeLow[node] || treeLim[other] > treeLim[node];
+
+        int value = (outside) ? 1 : ((r.treeIndex >= 0) ? r.cutValue : 0) - 1;
+
+        // Whether the edge crosses the cut the same way as the tree edge does
+        bool forwards = (tailSide) ? (r.head == node) : (r.tail == node);
+
+        if (outside) { forwards = !forwards; }
+
+        sum += (forwards) ? value : -value;
+
+    }
+
+    edge.cutValue = sum;
+
+}
+
+int HackAudio::DiagramLayout::findLeavingEdge()
+{
+
+    const int numTreeEdges = treeEdges.size();
+
+    int leaving = -1;
+    int found   = 0;
+
+    for (int i = 0; i < numTreeEdges; ++i)
+    {
+
+        const RankEdge& r = rankEdges.getReference(treeEdges[leaveCursor]);
+
+        if (r.cutValue < 0)
+        {
+
+            if (leaving < 0 || r.cutValue < rankEdges.getReference(leaving).cutValue)
+            {
+
+                leaving = treeEdges[leaveCursor];
+
+            }
+
+            if (++found == searchSize) { break; }
+
+        }
+
+        leaveCursor = (leaveCursor + 1) % numTreeEdges;
+
+    }
+
+    return leaving;
+
+}
+
+int HackAudio::DiagramLayout::findEnteringEdge(int leaving)
+{
+
+    const RankEdge& edge = rankEdges.getReference(leaving);
+
+    // The subtree below the leaving edge is searched for the tightest edge crossing back over the cut
+    const bool tailSide = treeLim[edge.tail] < treeLim[edge.head];
+    const int  node     = (tailSide) ? edge.tail : edge.head;
+
+    const int low = treeLow[node];
+    const int lim = treeLim[node];
+
+    int entering   = -1;
+    int tightest   = std::numeric_limits<int>::max();
+
+    for (int p = low; p <= lim; ++p)
+    {
+
+        const int member = postorder[p];
+
+        for (int i = incidentStart[member]; i < incidentStart[member + 1]; ++i)
+        {
+
+            const int e = incidentEdges[i];
+            const RankEdge& r = rankEdges.getReference(e);
+
+            if (r.treeIndex >= 0 || (tailSide ? r.head : r.tail) != member) { continue; }
+
+            const int other = (tailSide) ? r.tail : r.head;
+
+            if (treeLim[other] >= low && treeLim[other] <= lim) { continue; }
+
+            const int slack = getSlack(e);
+
+            if (slack < tightest)
+            {
+
+                entering = e;
+                tightest = slack;
+
+                if (slack == 0) { return entering; }
+
+            }
+
+        }
+
+    }
+
+    return entering;
+
+}
+
+void HackAudio::DiagramLayout::exchangeTreeEdges(int leaving, int entering)
+{
+
+    RankEdge& out = rankEdges.getReference(leaving);
+    RankEdge& in  = rankEdges.getReference(entering);
+
+    const int slack = getSlack(entering);
+
+    if (slack > 0)
+    {
+
+        // Either side of the cut can move to tighten the entering edge, so the smaller one does
+        const int node  = (treeLim[out.tail] < treeLim[out.head]) ? out.tail : out.head;
+        const int root  = treeRoots[treeComponent[node]];
+        const int shift = (node == out.tail) ? -slack : slack;
+
+        const int subtreeSize = treeLim[node] - treeLow[node] + 1;
+
+        if (2 * subtreeSize <= treeLim[root] - treeLow[root] + 1)
+        {
+
+            for (int p = treeLow[node]; p <= treeLim[node]; ++p)
+            {
+
+                nodes.getReference(postorder[p]).layer += shift;
+
+            }
+
+        }
+        else
+        {
+
+            for (int p = treeLow[root]; p <= treeLim[root]; ++p)
+            {
+
+                if (p == treeLow[node]) { p = treeLim[node]; continue; }
+
+                nodes.getReference(postorder[p]).layer -= shift;
+
+            }
+
+        }
+
+    }
+
+    // The lower end of the leaving edge and both ends of the entering one, by their postorder numbers before the exchange
+    const int reshaped[] =
+    {
+        juce::jmin(treeLim[out.tail], treeLim[out.head]),
+        treeLim[in.tail],
+        treeLim[in.head]
+    };
+
+    const int cutValue = out.cutValue;
+    const int ancestor = updateCutValues(in.tail, in.head, cutValue, true);
+
+    updateCutValues(in.head, in.tail, cutValue, false);
+
+    in.cutValue  = -cutValue;
+    out.cutValue = 0;
+
+    in.treeIndex  = out.treeIndex;
+    out.treeIndex = -1;
+
+    treeEdges.set(in.treeIndex, entering);
+
+    // Only the subtree above the new tree path has changed shape
+    setTreeRanges(ancestor, treeLow[ancestor], reshaped, 3);
+
+}
+
+int HackAudio::DiagramLayout::updateCutValues(int from, int to, int cutValue, bool tailwards)
+{
+
+    // Climbs from one end of the entering edge until its subtree holds the other end
+    while (treeLim[to] < treeLow[from] || treeLim[to] > treeLim[from])
+    {
+
+        RankEdge& r = rankEdges.getReference(treeParent[from]);
+
+        const bool adding = (from == r.tail) ? tailwards : !tailwards;
+
+        r.cutValue += (adding) ? cutValue : -cutValue;
+
+        from = (treeLim[r.tail] > treeLim[r.head]) ? r.tail : r.head;
+
+    }
+
+    return from;
+
+}
+
+int HackAudio::DiagramLayout::getSlack(int rankEdge) const
+{
+
+    const RankEdge& r = rankEdges.getReference(rankEdge);
+
+    return nodes.getReference(r.head).layer - nodes.getReference(r.tail).layer - 1;
+
+}
+
+bool HackAudio::DiagramLayout::buildLayeredGraph(const ExitCheck& shouldExit)
+{
+
+    const int numNodes = nodes.size();
+    const int numEdges = edges.size();
+
+    vertices.clearQuick();
+    chainStart.clearQuick();
+    chainVertices.clearQuick();
+
+    // Reserving room for every dummy up front saves copying a large graph's vertices each time they grow
+    int numDummies = 0;
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        const Edge& edge = edges.getReference(e);
+
+        if (edge.source != edge.destination)
+        {
+
+            numDummies += std::abs(nodes.getReference(edge.destination).layer - nodes.getReference(edge.source).layer) - 1;
+
+        }
+
+    }
+
+    vertices.ensureStorageAllocated(numNodes + numDummies);
+    chainStart.ensureStorageAllocated(numEdges + 1);
+    chainVertices.ensureStorageAllocated(numDummies + 2 * numEdges);
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        const Node& node = nodes.getReference(n);
+
+        Vertex v;
+        v.layer    = node.layer;
+        v.position = 0;
+        v.height   = node.height;
+        v.y        = 0.0;
+
+        vertices.add(v);
+
+    }
+
+    // Edges that span several layers are split by a zero sized dummy vertex in every layer they pass through
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        const Edge& edge = edges.getReference(e);
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        chainStart.add(chainVertices.size());
+
+        if (edge.source == edge.destination) { continue; }
+
+        int from = (edge.reversed) ? edge.destination : edge.source;
+        int to   = (edge.reversed) ? edge.source : edge.destination;
+
+        chainVertices.add(from);
+
+        for (int layer = nodes.getReference(from).layer + 1; layer < nodes.getReference(to).layer; ++layer)
+        {
+
+            Vertex dummy;
+            dummy.layer    = layer;
+            dummy.position = 0;
+            dummy.height   = 0;
+            dummy.y        = 0.0;
+
+            chainVertices.add(vertices.size());
+            vertices.add(dummy);
+
+        }
+
+        chainVertices.add(to);
+
+    }
+
+    chainStart.add(chainVertices.size());
+
+    const int numVertices = vertices.size();
+
+    // Neighbours in the previous and next layers, grouped by vertex
+    inputStart.clearQuick();
+    outputStart.clearQuick();
+
+    inputStart.insertMultiple(0, 0, numVertices + 1);
+    outputStart.insertMultiple(0, 0, numVertices + 1);
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        for (int i = chainStart[e] + 1; i < chainStart[e + 1]; ++i)
+        {
+
+            outputStart.getReference(chainVertices[i - 1] + 1)++;
+            inputStart.getReference(chainVertices[i] + 1)++;
+
+        }
+
+    }
+
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        inputStart.getReference(v + 1)  += inputStart[v];
+        outputStart.getReference(v + 1) += outputStart[v];
+
+    }
+
+    if (shouldExit && shouldExit()) { return false; }
+
+    inputVertices.clearQuick();
+    outputVertices.clearQuick();
+
+    inputVertices.insertMultiple(0, 0, inputStart[numVertices]);
+    outputVertices.insertMultiple(0, 0, outputStart[numVertices]);
+
+    {
+
+        juce::HeapBlock<int> inputCursor(numVertices);
+        juce::HeapBlock<int> outputCursor(numVertices);
+
+        for (int v = 0; v < numVertices; ++v)
+        {
+
+            inputCursor[v]  = inputStart[v];
+            outputCursor[v] = outputStart[v];
+
+        }
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        for (int e = 0; e < numEdges; ++e)
+        {
+
+            if (shouldExit && shouldExit()) { return false; }
+
+            for (int i = chainStart[e] + 1; i < chainStart[e + 1]; ++i)
+            {
+
+                int from = chainVertices[i - 1];
+                int to   = chainVertices[i];
+
+                outputVertices.set(outputCursor[from]++, to);
+                inputVertices.set(inputCursor[to]++, from);
+
+            }
+
+        }
+
+    }
+
+    if (shouldExit && shouldExit()) { return false; }
+
+    // Layers start out in the order their vertices were added
+    layerStart.clearQuick();
+    layerStart.insertMultiple(0, 0, numLayers + 1);
+
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        layerStart.getReference(vertices.getReference(v).layer + 1)++;
+
+    }
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        layerStart.getReference(layer + 1) += layerStart[layer];
+
+    }
+
+    if (shouldExit && shouldExit()) { return false; }
+
+    layerVertices.clearQuick();
+    layerVertices.insertMultiple(0, 0, numVertices);
+
+    {
+
+        juce::HeapBlock<int> cursor(numLayers);
+
+        for (int layer = 0; layer < numLayers; ++layer)
+        {
+
+            cursor[layer] = layerStart[layer];
+
+        }
+
+        for (int v = 0; v < numVertices; ++v)
+        {
+
+            Vertex& vertex = vertices.getReference(v);
+
+            vertex.position = cursor[vertex.layer] - layerStart[vertex.layer];
+            layerVertices.set(cursor[vertex.layer]++, v);
+
+        }
+
+    }
+
+    return true;
+
+}
+
+bool HackAudio::DiagramLayout::orderLayers(const ExitCheck& shouldExit)
+{
+
+    const int numVertices = vertices.size();
+
+    int maxLayerSize = 0;
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        maxLayerSize = juce::jmax(maxLayerSize, layerStart[layer + 1] - layerStart[layer]);
+
+    }
+
+    sortEntries.malloc(maxLayerSize);
+    crossingTree.malloc(maxLayerSize + 1);
+
+    int bestCrossings = 0;
+
+    for (int layer = 0; layer < numLayers - 1; ++layer)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        bestCrossings += countCrossings(layer);
+
+    }
+
+    juce::HeapBlock<int> bestPositions(numVertices);
+
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        bestPositions[v] = vertices.getReference(v).position;
+
+    }
+
+    int sweepsWithoutImprovement = 0;
+
+    // Once neither direction has helped there's nothing left for the heuristic to find
+    for (int sweep = 0; sweep < numSweeps && bestCrossings > 0 && sweepsWithoutImprovement < 2; ++sweep)
+    {
+
+        bool downwards = (sweep % 2 == 0);
+
+        // A sweep over a large graph can take a while, so it's abandoned a layer at a time
+        if (downwards)
+        {
+
+            for (int layer = 1; layer < numLayers; ++layer)
+            {
+
+                if (shouldExit && shouldExit()) { return false; }
+
+                sortLayer(layer, true);
+
+            }
+
+        }
+        else
+        {
+
+            for (int layer = numLayers - 2; layer >= 0; --layer)
+            {
+
+                if (shouldExit && shouldExit()) { return false; }
+
+                sortLayer(layer, false);
+
+            }
+
+        }
+
+        int crossings = 0;
+
+        for (int layer = 0; layer < numLayers - 1; ++layer)
+        {
+
+            if (shouldExit && shouldExit()) { return false; }
+
+            crossings += countCrossings(layer);
+
+        }
+
+        ++sweepsWithoutImprovement;
+
+        if (crossings < bestCrossings)
+        {
+
+            bestCrossings = crossings;
+            sweepsWithoutImprovement = 0;
+
+            for (int v = 0; v < numVertices; ++v)
+            {
+
+                bestPositions[v] = vertices.getReference(v).position;
+
+            }
+
+        }
+
+    }
+
+    // Restore the best ordering found, a layer at a time
+    SortEntry* entries = sortEntries.getData();
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        const int first = layerStart[layer];
+        const int size  = layerStart[layer + 1] - first;
+
+        for (int i = 0; i < size; ++i)
+        {
+
+            entries[i].vertex = layerVertices[first + i];
+
+        }
+
+        for (int i = 0; i < size; ++i)
+        {
+
+            int v = entries[i].vertex;
+
+            vertices.getReference(v).position = bestPositions[v];
+            layerVertices.set(first + bestPositions[v], v);
+
+        }
+
+    }
+
+    numCrossings = bestCrossings;
+
+    return true;
+
+}
+
+void HackAudio::DiagramLayout::sortLayer(int layer, bool downwards)
+{
+
+    const int first = layerStart[layer];
+    const int size  = layerStart[layer + 1] - first;
+
+    const juce::Array<int>& neighbourStart = (downwards) ? inputStart : outputStart;
+    const juce::Array<int>& neighbours     = (downwards) ? inputVertices : outputVertices;
+
+    SortEntry* entries = sortEntries.getData();
+
+    for (int i = 0; i < size; ++i)
+    {
+
+        int v = layerVertices.getUnchecked(first + i);
+
+        int begin = neighbourStart.getUnchecked(v);
+        int end   = neighbourStart.getUnchecked(v + 1);
+
+        // The barycentre of the neighbours in the layer just ordered, a vertex without any keeps its place
+        double key = i;
+
+        if (end > begin)
+        {
+
+            double sum = 0.0;
+
+            for (int n = begin; n < end; ++n)
+            {
+
+                sum += vertices.getReference(neighbours.getUnchecked(n)).position;
+
+            }
+
+            key = sum / (end - begin);
+
+        }
+
+        entries[i].key      = key;
+        entries[i].vertex   = v;
+        entries[i].position = i;
+
+    }
+
+    // Ties keep their current order
+    std::sort(entries, entries + size, [](const SortEntry& a, const SortEntry& b)
+    {
+
+        return (a.key != b.key) ? a.key < b.key : a.position < b.position;
+
+    });
+
+    for (int i = 0; i < size; ++i)
+    {
+
+        layerVertices.set(first + i, entries[i].vertex);
+        vertices.getReference(entries[i].vertex).position = i;
+
+    }
+
+}
+
+int HackAudio::DiagramLayout::countCrossings(int layer)
+{
+
+    // Counts the inversions in the next layer's positions, read in this layer's order, with a Fenwick tree
+    const int first     = layerStart[layer];
+    const int size      = layerStart[layer + 1] - first;
+    const int nextSize  = layerStart[layer + 2] - layerStart[layer + 1];
+
+    int* tree = crossingTree.getData();
+
+    std::fill(tree, tree + nextSize + 1, 0);
+
+    int inserted  = 0;
+    int crossings = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+
+        int v = layerVertices.getUnchecked(first + i);
+
+        int begin = outputStart.getUnchecked(v);
+        int end   = outputStart.getUnchecked(v + 1);
+
+        for (int n = begin; n < end; ++n)
+        {
+
+            int position = vertices.getReference(outputVertices.getUnchecked(n)).position;
+
+            int notAfter = 0;
+
+            for (int p = position + 1; p > 0; p -= (p & -p))
+            {
+
+                notAfter += tree[p];
+
+            }
+
+            crossings += inserted - notAfter;
+
+        }
+
+        for (int n = begin; n < end; ++n)
+        {
+
+            for (int p = vertices.getReference(outputVertices.getUnchecked(n)).position + 1; p <= nextSize; p += (p & -p))
+            {
+
+                tree[p]++;
+
+            }
+
+            ++inserted;
+
+        }
+
+    }
+
+    return crossings;
+
+}
+
+bool HackAudio::DiagramLayout::placeVertices(const ExitCheck& shouldExit)
+{
+
+    const int numVertices = vertices.size();
+
+    int maxLayerSize = 0;
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        maxLayerSize = juce::jmax(maxLayerSize, layerStart[layer + 1] - layerStart[layer]);
+
+    }
+
+    // Every layer starts out packed and centred on the same line
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        double offset = 0.0;
+
+        for (int i = layerStart[layer]; i < layerStart[layer + 1]; ++i)
+        {
+
+            Vertex& v = vertices.getReference(layerVertices[i]);
+
+            v.y = offset;
+            offset += v.height + nodeSpacing;
+
+        }
+
+        double centre = (offset - nodeSpacing) / 2.0;
+
+        for (int i = layerStart[layer]; i < layerStart[layer + 1]; ++i)
+        {
+
+            vertices.getReference(layerVertices[i]).y -= centre;
+
+        }
+
+    }
+
+    juce::HeapBlock<double> targets(maxLayerSize);
+    juce::HeapBlock<double> offsets(maxLayerSize);
+
+    juce::HeapBlock<double> blockSums(maxLayerSize);
+    juce::HeapBlock<int>    blockCounts(maxLayerSize);
+
+    for (int pass = 0; pass < 4; ++pass)
+    {
+
+        bool downwards = (pass % 2 == 0);
+
+        const juce::Array<int>& neighbourStart = (downwards) ? inputStart : outputStart;
+        const juce::Array<int>& neighbours     = (downwards) ? inputVertices : outputVertices;
+
+        for (int step = 1; step < numLayers; ++step)
+        {
+
+            if (shouldExit && shouldExit()) { return false; }
+
+            int layer = (downwards) ? step : numLayers - 1 - step;
+
+            const int first = layerStart[layer];
+            const int size  = layerStart[layer + 1] - first;
+
+            // Each vertex would like to be centred on its neighbours in the layer just placed
+            double offset = 0.0;
+
+            for (int i = 0; i < size; ++i)
+            {
+
+                int v = layerVertices[first + i];
+
+                const Vertex& vertex = vertices.getReference(v);
+
+                double target = vertex.y;
+
+                int begin = neighbourStart[v];
+                int end   = neighbourStart[v + 1];
+
+                if (end > begin)
+                {
+
+                    double sum = 0.0;
+
+                    for (int n = begin; n < end; ++n)
+                    {
+
+                        const Vertex& neighbour = vertices.getReference(neighbours[n]);
+
+                        sum += neighbour.y + neighbour.height / 2.0;
+
+                    }
+
+                    target = sum / (end - begin) - vertex.height / 2.0;
+
+                }
+
+                offsets[i] = offset;
+                targets[i] = target - offset;
+
+                offset += vertex.height + nodeSpacing;
+
+            }
+
+            /*
+             With each vertex's packed offset subtracted, keeping the order and spacing only asks for the
+             remainders to never decrease, and pooling adjacent violators gives the closest such sequence
+            */
+            int numBlocks = 0;
+
+            for (int i = 0; i < size; ++i)
+            {
+
+                blockSums[numBlocks]   = targets[i];
+                blockCounts[numBlocks] = 1;
+                ++numBlocks;
+
+                while (numBlocks > 1 && blockSums[numBlocks - 2] / blockCounts[numBlocks - 2] > blockSums[numBlocks - 1] / blockCounts[numBlocks - 1])
+                {
+
+                    blockSums[numBlocks - 2]   += blockSums[numBlocks - 1];
+                    blockCounts[numBlocks - 2] += blockCounts[numBlocks - 1];
+                    --numBlocks;
+
+                }
+
+            }
+
+            for (int block = 0, i = 0; block < numBlocks; ++block)
+            {
+
+                double value = blockSums[block] / blockCounts[block];
+
+                for (int j = 0; j < blockCounts[block]; ++j, ++i)
+                {
+
+                    vertices.getReference(layerVertices[first + i]).y = value + offsets[i];
+
+                }
+
+            }
+
+        }
+
+    }
+
+    /*
+     Centres snap to whole pixels before anything is measured from them. A vertex centred on a neighbour
+     whose height has the other parity sits on a half pixel, and rounding its top instead of its centre
+     would turn the straight edge between them into a one pixel jog
+    */
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        Vertex& vertex = vertices.getReference(v);
+
+        vertex.y = std::floor(vertex.y + vertex.height / 2.0 + 0.5) - vertex.height / 2;
+
+    }
+
+    // Snapping can close the spacing between neighbours by a pixel, which is only undone where they'd overlap
+    const int snappedSpacing = juce::jmax(0, nodeSpacing - 1);
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        for (int i = layerStart[layer] + 1; i < layerStart[layer + 1]; ++i)
+        {
+
+            const Vertex& above = vertices.getReference(layerVertices[i - 1]);
+            Vertex& vertex      = vertices.getReference(layerVertices[i]);
+
+            vertex.y = juce::jmax(vertex.y, above.y + above.height + snappedSpacing);
+
+        }
+
+    }
+
+    // Move everything down so the topmost vertex sits at zero
+    double top = 0.0;
+
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        top = (v == 0) ? vertices.getReference(v).y : juce::jmin(top, vertices.getReference(v).y);
+
+    }
+
+    for (int v = 0; v < numVertices; ++v)
+    {
+
+        vertices.getReference(v).y -= top;
+
+    }
+
+    return true;
+
+}
+
+bool HackAudio::DiagramLayout::routeEdges(const ExitCheck& shouldExit)
+{
+
+    struct Bus
+    {
+        int top;
+        int bottom;
+        int vertex;
+    };
+
+    const int numNodes    = nodes.size();
+    const int numVertices = vertices.size();
+
+    int maxLayerSize = 0;
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        maxLayerSize = juce::jmax(maxLayerSize, layerStart[layer + 1] - layerStart[layer]);
+
+    }
+
+    // The edges leaving a vertex across a gap share one vertical track, spanning all their destinations
+    juce::HeapBlock<Bus> buses(juce::jmax(1, maxLayerSize));
+    juce::HeapBlock<int> tracks(numVertices);
+
+    juce::HeapBlock<int> numTracks(juce::jmax(1, numLayers), true);
+    juce::Array<int> trackBottoms;
+
+    // Each gap is coloured on its own, so a large graph can be abandoned between them
+    for (int gap = 0; gap < numLayers; ++gap)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        int numBuses = 0;
+
+        for (int i = layerStart[gap]; i < layerStart[gap + 1]; ++i)
+        {
+
+            int v = layerVertices[i];
+
+            tracks[v] = -1;
+
+            int y = getCentreY(v);
+
+            int top    = y;
+            int bottom = y;
+
+            for (int n = outputStart[v]; n < outputStart[v + 1]; ++n)
+            {
+
+                int destinationY = getCentreY(outputVertices[n]);
+
+                top    = juce::jmin(top, destinationY);
+                bottom = juce::jmax(bottom, destinationY);
+
+            }
+
+            if (top == bottom) { continue; }
+
+            buses[numBuses].top    = top;
+            buses[numBuses].bottom = bottom;
+            buses[numBuses].vertex = v;
+
+            ++numBuses;
+
+        }
+
+        std::sort(buses.getData(), buses.getData() + numBuses, [](const Bus& a, const Bus& b)
+        {
+
+            return a.top < b.top;
+
+        });
+
+        // Interval colouring, each bus takes the first track that's free by the time it starts
+        trackBottoms.clearQuick();
+
+        for (int i = 0; i < numBuses; ++i)
+        {
+
+            const Bus& bus = buses[i];
+
+            int track = 0;
+
+            while (track < trackBottoms.size() && trackBottoms[track] + trackSpacing > bus.top)
+            {
+
+                ++track;
+
+            }
+
+            if (track == trackBottoms.size())
+            {
+
+                trackBottoms.add(bus.bottom);
+
+            }
+            else
+            {
+
+                trackBottoms.set(track, bus.bottom);
+
+            }
+
+            tracks[bus.vertex] = track;
+
+        }
+
+        numTracks[gap] = trackBottoms.size();
+
+    }
+
+    // Layers are as wide as their widest node, and gaps as wide as their tracks need
+    juce::HeapBlock<int> layerX(numLayers + 1);
+    juce::HeapBlock<int> layerWidth(numLayers, true);
+    juce::HeapBlock<int> gapWidth(numLayers, true);
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        const Node& node = nodes.getReference(n);
+
+        layerWidth[node.layer] = juce::jmax(layerWidth[node.layer], node.width);
+
+    }
+
+    layerX[0] = 0;
+
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+
+        gapWidth[layer]   = juce::jmax(layerSpacing, (numTracks[layer] + 1) * (int)trackSpacing);
+        layerX[layer + 1] = layerX[layer] + layerWidth[layer] + gapWidth[layer];
+
+    }
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        Node& node = nodes.getReference(n);
+
+        node.x = layerX[node.layer] + (layerWidth[node.layer] - node.width) / 2;
+        node.y = juce::roundToInt(vertices.getReference(n).y);
+
+    }
+
+    for (int e = 0; e < edges.size(); ++e)
+    {
+
+        if (shouldExit && shouldExit()) { return false; }
+
+        Edge& edge = edges.getReference(e);
+
+        edge.waypoints.clearQuick();
+
+        for (int i = chainStart[e] + 1; i < chainStart[e + 1]; ++i)
+        {
+
+            int from = chainVertices[i - 1];
+            int to   = chainVertices[i];
+
+            int fromY = getCentreY(from);
+            int toY   = getCentreY(to);
+
+            if (fromY == toY) { continue; }
+
+            int gap = vertices.getReference(from).layer;
+
+            int trackX = layerX[gap] + layerWidth[gap] + (gapWidth[gap] - (numTracks[gap] - 1) * trackSpacing) / 2 + tracks[from] * trackSpacing;
+
+            edge.waypoints.add(juce::Point<int>(trackX, fromY));
+            edge.waypoints.add(juce::Point<int>(trackX, toY));
+
+        }
+
+        if (edge.reversed)
+        {
+
+            for (int i = 0, j = edge.waypoints.size() - 1; i < j; ++i, --j)
+            {
+
+                edge.waypoints.swap(i, j);
+
+            }
+
+        }
+
+    }
+
+    return true;
+
+}
+
+int HackAudio::DiagramLayout::getCentreY(int vertex) const
+{
+
+    const Vertex& v = vertices.getReference(vertex);
+
+    return juce::roundToInt(v.y) + v.height / 2;
+
+}
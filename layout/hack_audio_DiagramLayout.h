@@ -0,0 +1,234 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HACK_AUDIO_DIAGRAMLAYOUT_H
+#define HACK_AUDIO_DIAGRAMLAYOUT_H
+
+namespace HackAudio
+{
+
+/**
+ A layered (Sugiyama style) layout of a directed graph of rectangular nodes that flows from left to right.
+
+ perform() breaks cycles by reversing feedback edges, assigns every node to a layer so that the edges span
+ as few layers in total as possible, orders each layer with barycentre sweeps to minimise edge crossings,
+ places the nodes in each layer as close to their neighbours as the spacing allows, and routes every edge
+ orthogonally through vertical tracks in the gaps between layers.
+
+ Nothing here touches a juce::Component, so a layout can be built and performed on any thread.
+*/
+class DiagramLayout
+{
+
+public:
+
+    DiagramLayout();
+    ~DiagramLayout();
+
+    /**
+     Polled between and during the stages of perform(), at least once per edge, layer or sweep, which
+     gives up as soon as it returns true
+    */
+    typedef std::function<bool()> ExitCheck;
+
+    /**
+     Removes every node and edge
+    */
+    void clear();
+
+    /**
+     Adds a node of the given size, returning its index
+    */
+    int addNode(int width, int height);
+
+    /**
+     Adds a directed edge between two nodes, returning its index
+    */
+    int addEdge(int source, int destination);
+
+    /**
+     Sets the minimum horizontal gap between neighbouring layers, and the vertical gap between neighbouring nodes in a layer
+    */
+    void setSpacing(int layerSpacing, int nodeSpacing);
+
+    /**
+     Sets how many down and up sweeps the crossing minimisation makes, the best ordering found is kept
+    */
+    void setNumSweeps(int numSweeps);
+
+    /**
+     Computes the layout, returning false if shouldExit asked for it to be abandoned
+    */
+    bool perform(ExitCheck shouldExit = nullptr);
+
+    int getNumNodes() const;
+    int getNumEdges() const;
+
+    /**
+     Returns the top left corner of a node after perform()
+    */
+    juce::Point<int> getNodePosition(int node) const;
+
+    /**
+     Returns the layer a node was assigned to by perform(), counting from the left
+    */
+    int getNodeLayer(int node) const;
+
+    /**
+     Returns the corners an edge turns at between leaving its source and arriving at its destination,
+     or an empty array if the edge is a straight horizontal line
+    */
+    const juce::Array<juce::Point<int>>& getEdgeWaypoints(int edge) const;
+
+    /**
+     Returns the number of edge crossings between neighbouring layers in the final ordering
+    */
+    int getNumCrossings() const;
+
+private:
+
+    enum
+    {
+        trackSpacing = 8,    /**< The horizontal gap between the vertical tracks edges turn on in a gap between layers */
+        searchSize   = 30    /**< How many tree edges with negative cut values are compared when picking one to leave the tree */
+    };
+
+    struct Node
+    {
+        int width;
+        int height;
+        int layer;
+        int x;
+        int y;
+    };
+
+    struct Edge
+    {
+        int  source;
+        int  destination;
+        bool reversed;      /**< Set when the edge closes a cycle and is laid out from destination to source */
+        juce::Array<juce::Point<int>> waypoints;
+    };
+
+    /**
+     A vertex of the proper layered graph, either one of the nodes or a dummy on an edge that spans several layers
+    */
+    struct Vertex
+    {
+        int    layer;
+        int    position;    /**< The index within its layer */
+        int    height;
+        double y;
+    };
+
+    void breakCycles();
+    bool assignLayers(const ExitCheck& shouldExit);
+    bool buildLayeredGraph(const ExitCheck& shouldExit);
+    bool orderLayers(const ExitCheck& shouldExit);
+    bool placeVertices(const ExitCheck& shouldExit);
+    bool routeEdges(const ExitCheck& shouldExit);
+
+    void sortLayer(int layer, bool downwards);
+    int countCrossings(int layer);
+
+    void findFeasibleTree();
+    int setTreeRanges(int root, int first, const int* reshaped = nullptr, int numReshaped = 0);
+    void setCutValue(int rankEdge);
+    int findLeavingEdge();
+    int findEnteringEdge(int leaving);
+    void exchangeTreeEdges(int leaving, int entering);
+    int updateCutValues(int from, int to, int cutValue, bool tailwards);
+    int getSlack(int rankEdge) const;
+
+    int getCentreY(int vertex) const;
+
+    juce::Array<Node> nodes;
+    juce::Array<Edge> edges;
+
+    int layerSpacing;
+    int nodeSpacing;
+    int numSweeps;
+    int numCrossings;
+    int numLayers;
+
+    /**
+     An edge of the ranking problem, pointing from its lower layer to its higher one
+    */
+    struct RankEdge
+    {
+        int tail;
+        int head;
+        int cutValue;
+        int treeIndex;    /**< Its index in treeEdges, or -1 while it isn't in the spanning tree */
+    };
+
+    struct TreeCandidate
+    {
+        int key;
+        int edge;
+    };
+
+    // The ranking problem solved by network simplex in assignLayers(), rebuilt by every call to perform()
+    juce::Array<RankEdge> rankEdges;
+
+    juce::Array<int> incidentStart, incidentEdges;   /**< Each node's rank edges, in either direction */
+
+    juce::Array<int> treeEdges;
+    juce::Array<int> treeRoots;                      /**< The root of each connected component's spanning tree */
+
+    juce::HeapBlock<int> treeParent;                 /**< The rank edge to each node's parent, or -1 at a root */
+    juce::HeapBlock<int> treeLow, treeLim;           /**< The range of postorder numbers in each node's subtree */
+    juce::HeapBlock<int> treeComponent;              /**< The index into treeRoots of each node's component */
+    juce::HeapBlock<int> postorder;                  /**< The nodes by postorder number */
+    juce::HeapBlock<int> treeStack, treeCursors, treeOrder;
+
+    int leaveCursor;
+
+    // The layered graph, rebuilt by every call to perform()
+    juce::Array<Vertex> vertices;
+
+    juce::Array<int> inputStart, inputVertices;      /**< Each vertex's neighbours in the previous layer */
+    juce::Array<int> outputStart, outputVertices;    /**< Each vertex's neighbours in the next layer */
+
+    juce::Array<int> layerStart, layerVertices;      /**< Each layer's vertices in order */
+
+    juce::Array<int> chainStart, chainVertices;      /**< Each edge's vertices from its leftmost to its rightmost layer */
+
+    struct SortEntry
+    {
+        double key;
+        int    vertex;
+        int    position;
+    };
+
+    // Scratch space for ordering, sized for the largest layer
+    juce::HeapBlock<SortEntry> sortEntries;
+    juce::HeapBlock<int>       crossingTree;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagramLayout)
+
+};
+
+}
+
+#endif
@@ -52,6 +52,8 @@ HackAudio::Viewport::Viewport()
     
     draggable = true;
 
+    subDiagramCacheSize = 8;
+
 }
 
 HackAudio::Viewport::~Viewport()
@@ -98,6 +100,8 @@ void HackAudio::Viewport::setDiagram(HackAudio::Diagram& d)
     backButton.setVisible(false);
     topButton.setVisible(false);
 
+    releaseSubDiagrams();
+
     repaint();
 
 }
@@ -129,6 +133,8 @@ void HackAudio::Viewport::clearDiagram()
     backButton.setVisible(false);
     topButton.setVisible(false);
 
+    releaseSubDiagrams();
+
     repaint();
 
 }
@@ -150,6 +156,8 @@ void HackAudio::Viewport::traverseDown(HackAudio::Diagram &d)
     backButton.setVisible(true);
     topButton.setVisible(true);
 
+    releaseSubDiagrams();
+
 }
 
 void HackAudio::Viewport::traverseUp()
@@ -164,6 +172,8 @@ void HackAudio::Viewport::traverseUp()
 
     setDiagramViaTraversal(*d);
 
+    releaseSubDiagrams();
+
 }
 
 void HackAudio::Viewport::traverseTop()
@@ -207,6 +217,94 @@ void HackAudio::Viewport::setDraggable(bool isDraggable)
 
 }
 
+void HackAudio::Viewport::setSubDiagramCacheSize(int maxDiagrams)
+{
+
+    jassert(maxDiagrams >= 0);    /* Warning: Cache Size Must Not Be Negative */
+
+    subDiagramCacheSize = juce::jmax(0, maxDiagrams);
+    releaseSubDiagrams();
+
+}
+
+int HackAudio::Viewport::getSubDiagramCacheSize() const
+{
+
+    return subDiagramCacheSize;
+
+}
+
+void HackAudio::Viewport::touchSubDiagram(HackAudio::Diagram& owner, HackAudio::Diagram& subDiagram)
+{
+
+    for (int i = 0; i < cachedDiagrams.size(); ++i)
+    {
+
+        if (cachedDiagrams.getReference(i).diagram == &subDiagram)
+        {
+
+            cachedDiagrams.remove(i);
+            break;
+
+        }
+
+    }
+
+    CachedDiagram c;
+    c.owner   = &owner;
+    c.diagram = &subDiagram;
+
+    cachedDiagrams.add(c);
+
+}
+
+void HackAudio::Viewport::releaseSubDiagrams()
+{
+
+    for (;;)
+    {
+
+        // Releasing a diagram takes any sub-diagrams built inside it along with it
+        for (int i = cachedDiagrams.size(); --i >= 0;)
+        {
+
+            const CachedDiagram& c = cachedDiagrams.getReference(i);
+
+            if (c.owner == nullptr || c.diagram == nullptr)
+            {
+
+                cachedDiagrams.remove(i);
+
+            }
+
+        }
+
+        int numOutsideTraversal = 0;
+        int leastRecent = -1;
+
+        for (int i = 0; i < cachedDiagrams.size(); ++i)
+        {
+
+            if (!isInTraversal(*cachedDiagrams.getReference(i).diagram))
+            {
+
+                if (leastRecent == -1) { leastRecent = i; }
+
+                ++numOutsideTraversal;
+
+            }
+
+        }
+
+        if (numOutsideTraversal <= subDiagramCacheSize) { return; }
+
+        CachedDiagram c = cachedDiagrams.removeAndReturn(leastRecent);
+        c.owner->releaseSubDiagram(*c.diagram);
+
+    }
+
+}
+
 void HackAudio::Viewport::setDiagramViaTraversal(HackAudio::Diagram &d)
 {
 
@@ -313,16 +411,21 @@ void HackAudio::Viewport::mouseUp(const juce::MouseEvent& e)
     if (e.getNumberOfClicks() > 1 && !componentAnimator.isAnimating())
     {
 
-        for(juce::HashMap<juce::Component*, HackAudio::Diagram*>::Iterator it (currentContent->submap); it.next();)
+        HackAudio::Diagram* subDiagram = (e.eventComponent->isVisible()) ? currentContent->getSubDiagram(*e.eventComponent) : nullptr;
+
+        if (subDiagram)
         {
 
-            if (it.getKey()->isVisible() && it.getKey() == e.eventComponent)
+            if (currentContent->canReleaseSubDiagram(*subDiagram))
             {
 
-                traverseDown(*it.getValue());
-                return;
+                touchSubDiagram(*currentContent, *subDiagram);
 
             }
+
+            traverseDown(*subDiagram);
+            return;
+
         }
 
         juce::Rectangle<int> finalBounds = currentContent->getBounds();
@@ -89,10 +89,26 @@ public:
     */
     void setDraggable(bool isDraggable);
 
+    /**
+     Sets how many sub-diagrams built on demand are kept alive once they've left the traversal chain.
+     Past that, the least recently expanded ones are destroyed and rebuilt if they're expanded again.
+
+     @see Diagram::setSubDiagram
+    */
+    void setSubDiagramCacheSize(int maxDiagrams);
+
+    /**
+     Returns how many sub-diagrams built on demand are kept alive outside of the traversal chain
+    */
+    int getSubDiagramCacheSize() const;
+
 private:
 
     void setDiagramViaTraversal(HackAudio::Diagram& d);
 
+    void touchSubDiagram(HackAudio::Diagram& owner, HackAudio::Diagram& subDiagram);
+    void releaseSubDiagrams();
+
     void mouseEnter    (const juce::MouseEvent& e) override;
     void mouseExit     (const juce::MouseEvent& e) override;
     void mouseDown     (const juce::MouseEvent& e) override;
@@ -120,6 +136,18 @@ private:
 
     juce::Array<HackAudio::Diagram*> parentContent;
 
+    /**
+     A sub-diagram that was built on demand when it was expanded, along with the diagram that owns it
+    */
+    struct CachedDiagram
+    {
+        juce::Component::SafePointer<HackAudio::Diagram> owner;
+        juce::Component::SafePointer<HackAudio::Diagram> diagram;
+    };
+
+    int subDiagramCacheSize;
+    juce::Array<CachedDiagram> cachedDiagrams;  /**< From least to most recently expanded */
+
     NavigationButton backButton;
     NavigationButton topButton;
 
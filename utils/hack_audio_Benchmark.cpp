@@ -0,0 +1,293 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+HackAudio::Benchmark::Result HackAudio::Benchmark::run(juce::Component& component, const juce::String& name, int width, int height, int frames, AllocationCounter counter, FrameCallback onFrame)
+{
+
+    jassert(width > 0 && height > 0 && frames > 0);
+
+    component.setVisible(true);
+    component.setBounds(0, 0, width, height);
+
+    juce::Image image(juce::Image::ARGB, width, height, true);
+    juce::Graphics g(image);
+
+    // The first paint builds any cached images, which shouldn't count towards the steady state
+    component.paintEntireComponent(g, true);
+
+    const juce::int64 allocationsBefore = (counter) ? counter() : 0;
+    const juce::int64 ticksBefore       = juce::Time::getHighResolutionTicks();
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+
+        if (onFrame)
+            onFrame(frame);
+
+        component.paintEntireComponent(g, true);
+
+    }
+
+    const juce::int64 ticksAfter       = juce::Time::getHighResolutionTicks();
+    const juce::int64 allocationsAfter = (counter) ? counter() : 0;
+
+    Result result;
+
+    result.name   = name;
+    result.width  = width;
+    result.height = height;
+    result.frames = frames;
+
+    result.nanosecondsPerFrame = juce::Time::highResolutionTicksToSeconds(ticksAfter - ticksBefore) * 1.0e9 / frames;
+    result.allocationsPerFrame = (counter) ? (double)(allocationsAfter - allocationsBefore) / frames : -1.0;
+
+    return result;
+
+}
+
+HackAudio::Benchmark::Result HackAudio::Benchmark::runLayout(const juce::String& name, int numNodes, int numEdges, int runs, AllocationCounter counter)
+{
+
+    jassert(numNodes > 1 && numEdges >= 0 && runs > 0);
+
+    juce::Random random(numNodes * 31 + numEdges);
+
+    HackAudio::DiagramLayout layout;
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+
+        layout.addNode(40 + random.nextInt(80), 20 + random.nextInt(40));
+
+    }
+
+    for (int e = 0; e < numEdges; ++e)
+    {
+
+        const int source      = random.nextInt(numNodes - 1);
+        const int destination = source + 1 + random.nextInt(juce::jmin(50, numNodes - 1 - source));
+
+        if (random.nextInt(50) == 0)
+            layout.addEdge(destination, source);
+        else
+            layout.addEdge(source, destination);
+
+    }
+
+    // The first layout sizes the scratch space, which later layouts reuse
+    layout.perform();
+
+    const juce::int64 allocationsBefore = (counter) ? counter() : 0;
+    const juce::int64 ticksBefore       = juce::Time::getHighResolutionTicks();
+
+    for (int run = 0; run < runs; ++run)
+    {
+
+        layout.perform();
+
+    }
+
+    const juce::int64 ticksAfter       = juce::Time::getHighResolutionTicks();
+    const juce::int64 allocationsAfter = (counter) ? counter() : 0;
+
+    Result result;
+
+    result.name   = name;
+    result.width  = numNodes;
+    result.height = numEdges;
+    result.frames = runs;
+
+    result.nanosecondsPerFrame = juce::Time::highResolutionTicksToSeconds(ticksAfter - ticksBefore) * 1.0e9 / runs;
+    result.allocationsPerFrame = (counter) ? (double)(allocationsAfter - allocationsBefore) / runs : -1.0;
+
+    return result;
+
+}
+
+juce::Array<HackAudio::Benchmark::Result> HackAudio::Benchmark::runStandardSuite(int frames, AllocationCounter counter)
+{
+
+    juce::Array<Result> results;
+
+    {
+
+        // A stereo meter fed a slowly swelling block every frame, so its bars move like they do live
+        HackAudio::Meter meter;
+        meter.setMeterCalibration(HackAudio::Meter::Peak);
+        meter.setPeakStatus(true);
+        meter.setSampleSource(0);
+        meter.setSampleSource(1);
+
+        float block[512];
+
+        results.add(run(meter, "Meter", 48, 256, frames, counter, [&](int frame)
+        {
+
+            const float level = 0.5f + 0.5f * std::sin(frame * 0.05f);
+
+            for (int i = 0; i < 512; ++i)
+            {
+
+                block[i] = level * std::sin(i * 0.1f);
+
+            }
+
+            meter.pushSamples(0, block, 512);
+            meter.pushSamples(1, block, 512);
+            meter.refresh();
+
+        }));
+
+    }
+
+    {
+
+        // A 256 channel bridge, each channel swelling out of phase with its neighbours
+        HackAudio::MeterBridge bridge;
+        bridge.setMeterCalibration(HackAudio::Meter::Peak);
+        bridge.setPeakStatus(true);
+        bridge.setSampleSources(256);
+
+        float block[256][64];
+        const float* channels[256];
+
+        for (int channel = 0; channel < 256; ++channel)
+        {
+
+            channels[channel] = block[channel];
+
+        }
+
+        results.add(run(bridge, "MeterBridge", 1024, 256, frames, counter, [&](int frame)
+        {
+
+            for (int channel = 0; channel < 256; ++channel)
+            {
+
+                const float level = 0.5f + 0.5f * std::sin(frame * 0.05f + channel * 0.1f);
+
+                for (int i = 0; i < 64; ++i)
+                {
+
+                    block[channel][i] = level * std::sin(i * 0.1f);
+
+                }
+
+            }
+
+            bridge.pushSamples(channels, 256, 64);
+            bridge.refresh();
+
+        }));
+
+    }
+
+    {
+
+        HackAudio::Slider slider;
+        slider.setSliderStyle(juce::Slider::LinearVertical);
+
+        results.add(run(slider, "Slider", 64, 256, frames, counter, [&](int frame)
+        {
+
+            slider.setValue(0.5 + 0.5 * std::sin(frame * 0.05), juce::dontSendNotification);
+
+        }));
+
+    }
+
+    {
+
+        HackAudio::Graph graph;
+        graph.setBounds(0, 0, 512, 256);
+
+        for (int i = 0; i < 8; ++i)
+        {
+
+            HackAudio::Graph::Node* n = graph.add();
+            n->setXValue((i + 1) / 9.0f);
+            n->setYValue(0.5f + 0.4f * std::sin(i * 0.8f));
+
+        }
+
+        results.add(run(graph, "Graph", 512, 256, frames, counter));
+
+    }
+
+    {
+
+        HackAudio::Diagrams::DattorroReverb diagram;
+
+        results.add(run(diagram, "Diagram", 800, 480, frames, counter));
+
+    }
+
+    {
+
+        HackAudio::Diagrams::FDNReverb diagram;
+        HackAudio::Viewport viewport;
+
+        viewport.setDiagram(diagram);
+
+        results.add(run(viewport, "Viewport", 800, 480, frames, counter));
+
+    }
+
+    // A layout costs far more than a frame, so far fewer are performed
+    const int runs = juce::jmax(1, frames / 200);
+
+    results.add(runLayout("Layout", 1000, 3000, runs, counter));
+    results.add(runLayout("Layout", 3000, 9000, runs, counter));
+
+    return results;
+
+}
+
+juce::String HackAudio::Benchmark::format(const juce::Array<Result>& results)
+{
+
+    juce::String text;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+
+        const Result& r = results.getReference(i);
+
+        text << r.name.paddedRight(' ', 12)
+             << (juce::String(r.width) + "x" + juce::String(r.height)).paddedRight(' ', 12)
+             << juce::String(r.nanosecondsPerFrame, 1) << " ns/frame";
+
+        if (r.allocationsPerFrame >= 0.0)
+        {
+
+            text << ", " << juce::String(r.allocationsPerFrame, 2) << " allocations/frame";
+
+        }
+
+        text << juce::newLine;
+
+    }
+
+    return text;
+
+}
@@ -0,0 +1,120 @@
+/* Copyright (C) 2017 by Antonio Lassandro, HackAudio LLC
+ *
+ * hack_audio_gui is provided under the terms of The MIT License (MIT):
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HACK_AUDIO_BENCHMARK_H
+#define HACK_AUDIO_BENCHMARK_H
+
+namespace HackAudio
+{
+
+/**
+ Measures the cost of painting HackAudio components into an offscreen juce::Image, and of laying out diagrams.
+
+ Nothing here needs a display, so it can be run from a console app (with a
+ juce::ScopedJuceInitialiser_GUI in scope) to catch paint-path regressions in CI.
+ It's only built when HACK_AUDIO_ENABLE_BENCHMARKS is set to 1.
+*/
+class Benchmark
+{
+public:
+
+    /**
+     The measurements for one component
+    */
+    struct Result
+    {
+
+        juce::String name;
+
+        int width;
+        int height;
+        int frames;
+
+        double nanosecondsPerFrame;
+        double allocationsPerFrame;     /**< -1 if no AllocationCounter was supplied */
+
+    };
+
+    /**
+     Returns the total number of heap allocations made so far. JUCE has no portable way of
+     counting these, so supply one backed by your own global operator new to measure them
+    */
+    typedef std::function<juce::int64()> AllocationCounter;
+
+    /**
+     Called before every measured frame, e.g. to feed a meter new samples
+    */
+    typedef std::function<void(int frame)> FrameCallback;
+
+    /**
+     Sizes a component and paints it the given number of times, returning the average cost per frame
+
+     @param component   the component to paint
+     @param name        the name to report the result under
+     @param width       the width to lay the component out at
+     @param height      the height to lay the component out at
+     @param frames      the number of frames to paint
+     @param counter     an optional allocation counter
+     @param onFrame     an optional callback to animate the component between frames
+    */
+    static Result run(juce::Component& component, const juce::String& name, int width, int height, int frames,
+                      AllocationCounter counter = nullptr, FrameCallback onFrame = nullptr);
+
+    /**
+     Performs a DiagramLayout of a seeded pseudo-random diagram the given number of times, returning the
+     average cost per layout. The result's width and height hold the number of nodes and edges, and its
+     frames the number of layouts
+
+     Edges mostly run forwards to a node up to 50 places later, like a signal path with long sends, and
+     one in fifty runs backwards to close a feedback loop. The same sizes always give the same diagram, so
+     results are comparable between builds
+
+     @param name        the name to report the result under
+     @param numNodes    the number of nodes in the diagram
+     @param numEdges    the number of edges in the diagram
+     @param runs        the number of layouts to perform
+     @param counter     an optional allocation counter
+    */
+    static Result runLayout(const juce::String& name, int numNodes, int numEdges, int runs, AllocationCounter counter = nullptr);
+
+    /**
+     Builds a Meter, MeterBridge, Slider, Graph, Diagram and Viewport at representative sizes and benchmarks each of them,
+     then lays out diagrams of 1000 and 3000 nodes
+    */
+    static juce::Array<Result> runStandardSuite(int frames = 2000, AllocationCounter counter = nullptr);
+
+    /**
+     Formats a set of results as a plain text table, one component per line
+    */
+    static juce::String format(const juce::Array<Result>& results);
+
+private:
+
+    Benchmark();
+    JUCE_DECLARE_NON_COPYABLE (Benchmark)
+
+};
+
+}
+
+#endif